@@ -7,6 +7,7 @@
 #include "ChcInterpreter.h"
 #include "Normalizer.h"
 #include "Validator.h"
+#include "engine/Common.h"
 #include "engine/EngineFactory.h"
 #include "graph/ChcGraph.h"
 #include "graph/ChcGraphBuilder.h"
@@ -17,13 +18,14 @@
 #include "transformers/RemoveUnreachableNodes.h"
 #include "transformers/SimpleChainSummarizer.h"
 #include "transformers/TransformationPipeline.h"
+#include "utils/SmtSolver.h"
 
-#include <csignal>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
-
-#include <sys/types.h>
-#include <sys/wait.h>
-#include <unistd.h>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace osmttokens;
 
@@ -84,6 +86,7 @@ void ChcInterpreterContext::interpretCommand(ASTNode & node) {
                 reportError("Missing (set-logic) command, ignoring (declare-fun)");
             } else {
                 interpretDeclareFun(node);
+                systemCommands.push_back(&node);
             }
             break;
         }
@@ -92,6 +95,7 @@ void ChcInterpreterContext::interpretCommand(ASTNode & node) {
                 reportError("Missing (set-logic) command, ignoring (assert)");
             } else {
                 interpretAssert(node);
+                systemCommands.push_back(&node);
             }
             break;
         }
@@ -382,11 +386,20 @@ PTRef ChcInterpreterContext::parseTerm(const ASTNode & termNode) {
     }
 }
 
-VerificationResult ChcInterpreterContext::solve(std::string const & engine_s,
-                                                ChcDirectedHyperGraph const & hypergraph) {
+VerificationResult ChcInterpreterContext::solve(std::string const & engine_s, ChcDirectedHyperGraph const & hypergraph,
+                                                CancellationToken const & cancellationToken, LemmaBus * lemmaBus) {
+    CancellationToken::Scope scope(cancellationToken); // Solvers created by the engine are stopped with it
+    SMTSolverPool::Scope solverPool; // One-shot queries of the engine recycle solvers
     auto engine = EngineFactory(logic, opts).getEngine(engine_s);
-    auto result = engine->solve(hypergraph);
-    return result;
+    engine->setCancellationToken(cancellationToken);
+    engine->setLemmaBus(lemmaBus);
+    try {
+        return engine->solve(hypergraph);
+    } catch (std::logic_error const & e) {
+        // Engines may fail on queries interrupted by the stop, this is not an error
+        if (not cancellationToken.stopRequested()) { throw; }
+        return interruptedResult(cancellationToken, engine_s + ": Interrupted during a query");
+    }
 }
 
 bool ChcInterpreterContext::hasWorkAfterAnswer() const {
@@ -434,6 +447,24 @@ void ChcInterpreterContext::doWorkAfterAnswer(VerificationResult result, ChcDire
 }
 
 namespace {
+CancellationToken::Budget budgetFromOptions(Options const & options) {
+    CancellationToken::Budget budget;
+    if (options.hasOption(Options::TIME_LIMIT)) {
+        budget.time = std::chrono::seconds(std::stoul(options.getOption(Options::TIME_LIMIT)));
+    }
+    if (options.hasOption(Options::MEMORY_LIMIT)) {
+        budget.memoryMB = std::stoul(options.getOption(Options::MEMORY_LIMIT));
+    }
+    return budget;
+}
+
+void reportUnknown(VerificationResult const & result, Options const & options) {
+    int verbosity = std::stoi(options.getOrDefault(Options::VERBOSE, "0"));
+    if (verbosity > 0 and not result.hasWitness() and not result.getNoWitnessReason().empty()) {
+        std::cerr << "; " << result.getNoWitnessReason() << std::endl;
+    }
+}
+
 void printAnswer(VerificationAnswer answer) {
     switch (answer) {
         case VerificationAnswer::SAFE: {
@@ -451,14 +482,14 @@ void printAnswer(VerificationAnswer answer) {
 }
 } // namespace
 
-void ChcInterpreterContext::interpretCheckSat() {
-    Normalizer normalizer(logic);
-    auto normalizedSystem = normalizer.normalize(*system);
+ChcInterpreterContext::PreprocessedSystem ChcInterpreterContext::preprocessSystem() {
+    PreprocessedSystem preprocessed;
+    preprocessed.normalizer = std::make_unique<Normalizer>(logic);
+    auto normalizedSystem = preprocessed.normalizer->normalize(*system);
 
     auto hypergraph = ChcGraphBuilder(logic).buildGraph(normalizedSystem);
-    std::unique_ptr<ChcDirectedHyperGraph> originalGraph{nullptr};
     if (hasWorkAfterAnswer()) { // Store copy of the original graph for validating purposes
-        originalGraph = std::make_unique<ChcDirectedHyperGraph>(*hypergraph);
+        preprocessed.originalGraph = std::make_unique<ChcDirectedHyperGraph>(*hypergraph);
     }
 
     TransformationPipeline::pipeline_t transformations;
@@ -469,7 +500,12 @@ void ChcInterpreterContext::interpretCheckSat() {
     transformations.push_back(std::make_unique<MultiEdgeMerger>());
     // TODO: Try following MultiEdgeMerger by another round of SimpleChainSummarizer and/or SimpleNodeEliminator?
     auto [newGraph, translator] = TransformationPipeline(std::move(transformations)).transform(std::move(hypergraph));
-    hypergraph = std::move(newGraph);
+    preprocessed.graph = std::move(newGraph);
+    preprocessed.translator = std::move(translator);
+    return preprocessed;
+}
+
+void ChcInterpreterContext::interpretCheckSat() {
     // This if is needed to run the portfolio of multiple engines
     auto engineName = opts.getOrDefault(Options::ENGINE, "spacer");
     if (engineName.find(',') != std::string::npos) {
@@ -479,47 +515,117 @@ void ChcInterpreterContext::interpretCheckSat() {
         while (getline(ss, tmp, ',')) {
             engines.push_back(tmp);
         }
+        runPortfolio(engines);
+        return;
+    }
 
-        pid_t parent = getpid();
-        std::vector<pid_t> processes;
-        for (uint i = 0; i < engines.size(); i++) {
-            if (getpid() == parent) { processes.push_back(fork()); }
-            if (processes[i] == 0) {
-                // child process
-                auto result = solve(engines[i], *hypergraph);
-                if (result.getAnswer() == VerificationAnswer::UNKNOWN) { exit(1); }
-                printAnswer(result.getAnswer());
-                if (hasWorkAfterAnswer()) {
-                    doWorkAfterAnswer(std::move(result), *originalGraph, *translator,
-                                      normalizer.getNormalizingEqualities());
-                }
-                return;
-            }
-        }
+    auto cancellationToken = CancellationToken::create(budgetFromOptions(opts));
+    CancellationToken::Watchdog watchdog(cancellationToken);
+    auto preprocessed = preprocessSystem();
+    auto result = solve(engineName, *preprocessed.graph, cancellationToken);
+    printAnswer(result.getAnswer());
+    if (result.getAnswer() == VerificationAnswer::UNKNOWN) { reportUnknown(result, opts); }
+    if (result.getAnswer() != VerificationAnswer::UNKNOWN and hasWorkAfterAnswer()) {
+        doWorkAfterAnswer(std::move(result), *preprocessed.originalGraph, *preprocessed.translator,
+                          preprocessed.normalizer->getNormalizingEqualities());
+    }
+}
 
-        while (true) {
-            int status;
-            // Parent process waits until at least one child finishes
-            pid_t done = wait(&status);
-            if (done == -1) {
-                // If all the children processes are finished, we stop
-                if (errno == ECHILD) return;
-            } else {
-                // If some child process encountered error, we continue, otherwise if it returned
-                // SAT/UNSAT we stop all other children and exit the parent process
-                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) { continue; }
-                for (auto k_p : processes) {
-                    kill(k_p, SIGKILL);
+namespace {
+std::unique_ptr<Logic> newLogicOfSameKind(Logic & logic) {
+    auto * arithLogic = dynamic_cast<ArithLogic *>(&logic);
+    if (not arithLogic) { throw std::logic_error("Portfolio supports only arithmetic logics"); }
+    return std::make_unique<ArithLogic>(arithLogic->hasIntegers() ? opensmt::Logic_t::QF_LIA
+                                                                  : opensmt::Logic_t::QF_LRA);
+}
+} // namespace
+
+std::unique_ptr<ChcInterpreterContext> ChcInterpreterContext::replayIn(Logic & otherLogic) const {
+    auto context = std::make_unique<ChcInterpreterContext>(otherLogic, opts);
+    context->system = std::make_unique<ChcSystem>();
+    for (ASTNode * command : systemCommands) {
+        context->interpretCommand(*command);
+    }
+    return context;
+}
+
+/*
+ * Runs the engines in parallel threads and reports the first definitive answer.
+ *
+ * The term store of OpenSMT is not thread-safe, so each engine works in its own logic with its own copy of the system,
+ * obtained by replaying the input commands. The first engine reuses the logic of this context.
+ * The engines exchange proven invariants through a shared lemma bus.
+ * Once an answer is found, the remaining engines are cancelled and joined.
+ */
+void ChcInterpreterContext::runPortfolio(std::vector<std::string> const & engines) {
+    struct Member {
+        std::unique_ptr<Logic> logic;
+        std::unique_ptr<ChcInterpreterContext> context;
+        PreprocessedSystem preprocessed;
+        std::optional<VerificationResult> result;
+    };
+    std::vector<Member> members(engines.size());
+    for (std::size_t i = 1; i < members.size(); ++i) {
+        members[i].logic = newLogicOfSameKind(logic);
+    }
+
+    auto cancellationToken = CancellationToken::create(budgetFromOptions(opts));
+    CancellationToken::Watchdog watchdog(cancellationToken);
+    LemmaBus lemmaBus;
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    std::size_t running = engines.size();
+    std::optional<std::size_t> winner;
+
+    std::vector<std::thread> threads;
+    threads.reserve(engines.size());
+    for (std::size_t i = 0; i < engines.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            auto & member = members[i];
+            try {
+                if (member.logic) { member.context = replayIn(*member.logic); }
+                ChcInterpreterContext & context = member.context ? *member.context : *this;
+                member.preprocessed = context.preprocessSystem();
+                member.result.emplace(
+                    context.solve(engines[i], *member.preprocessed.graph, cancellationToken, &lemmaBus));
+            } catch (std::exception const & e) {
+                // This engine simply does not provide an answer; cancelled engines may fail on interrupted queries
+                if (not cancellationToken.stopRequested()) {
+                    std::cerr << "; Engine " << engines[i] << " failed: " << e.what() << std::endl;
                 }
-                return;
             }
-        }
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            if (not winner.has_value() and member.result.has_value() and
+                member.result->getAnswer() != VerificationAnswer::UNKNOWN) {
+                winner = i;
+                cancellationToken.requestStop();
+            }
+            finishedCondition.notify_one();
+        });
     }
 
-    auto result = solve(engineName, *hypergraph);
-    printAnswer(result.getAnswer());
-    if (result.getAnswer() != VerificationAnswer::UNKNOWN and hasWorkAfterAnswer()) {
-        doWorkAfterAnswer(std::move(result), *originalGraph, *translator, normalizer.getNormalizingEqualities());
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finishedCondition.wait(lock, [&]() { return winner.has_value() or running == 0; });
+    }
+    if (winner.has_value()) {
+        auto & member = members[winner.value()];
+        ChcInterpreterContext & context = member.context ? *member.context : *this;
+        printAnswer(member.result->getAnswer());
+        if (hasWorkAfterAnswer()) {
+            context.doWorkAfterAnswer(std::move(member.result).value(), *member.preprocessed.originalGraph,
+                                      *member.preprocessed.translator,
+                                      member.preprocessed.normalizer->getNormalizingEqualities());
+        }
+    } else {
+        printAnswer(VerificationAnswer::UNKNOWN);
+        for (auto const & member : members) {
+            if (member.result.has_value()) { reportUnknown(member.result.value(), opts); }
+        }
+    }
+    for (auto & thread : threads) {
+        thread.join();
     }
 }
 
@@ -13,6 +13,8 @@
 
 #include "proofs/Term.h"
 #include "transformers/Transformer.h"
+#include "utils/CancellationToken.h"
+#include "utils/LemmaBus.h"
 
 #include "osmt_parser.h"
 
@@ -103,9 +105,18 @@ private:
     Options const & opts;
     std::unique_ptr<ChcSystem> system;
     std::vector<std::shared_ptr<Term>> originalAssertions;
+    // Interpreted (declare-fun) and (assert) commands; replayed to build a copy of the system in a different logic
+    std::vector<ASTNode *> systemCommands;
     bool doExit = false;
     LetRecords letRecords;
 
+    struct PreprocessedSystem {
+        std::unique_ptr<Normalizer> normalizer;
+        std::unique_ptr<ChcDirectedHyperGraph> graph;
+        std::unique_ptr<ChcDirectedHyperGraph> originalGraph;
+        std::unique_ptr<WitnessBackTranslator> translator;
+    };
+
     void interpretCommand(ASTNode & node);
 
     void interpretDeclareFun(ASTNode & node);
@@ -114,9 +125,16 @@ private:
 
     void interpretCheckSat();
 
+    PreprocessedSystem preprocessSystem();
+
+    void runPortfolio(std::vector<std::string> const & engines);
+
+    std::unique_ptr<ChcInterpreterContext> replayIn(Logic & otherLogic) const;
+
     static void reportError(std::string const & msg);
 
-    VerificationResult solve(std::string const & engine, ChcDirectedHyperGraph const & hyperGraph);
+    VerificationResult solve(std::string const & engine, ChcDirectedHyperGraph const & hyperGraph,
+                             CancellationToken const & cancellationToken = {}, LemmaBus * lemmaBus = nullptr);
 
     bool hasWorkAfterAnswer() const;
 
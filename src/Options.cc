@@ -22,8 +22,18 @@ const std::string Options::LRA_ITP_ALG = "lra-itp-algorithm";
 const std::string Options::FORCED_COVERING = "forced-covering";
 const std::string Options::VERBOSE = "verbose";
 const std::string Options::TPA_USE_QE = "tpa.use-qe";
+const std::string Options::TPA_REBUILD = "tpa.rebuild";
+const std::string Options::TPA_THREADS = "tpa.threads";
+const std::string Options::TPA_CACHE_SIZE = "tpa.cache-size";
+const std::string Options::TPA_NETWORK_THREADS = "tpa.network-threads";
+const std::string Options::SPACER_PUSH_THREADS = "spacer.push-threads";
+const std::string Options::KIND_PARALLEL = "kind.parallel";
+const std::string Options::BMC_THREADS = "bmc.threads";
+const std::string Options::BMC_JUMP = "bmc.jump";
 const std::string Options::FORCE_TS = "force-ts";
 const std::string Options::PROOF_FORMAT = "proof-format";
+const std::string Options::TIME_LIMIT = "time-limit";
+const std::string Options::MEMORY_LIMIT = "memory-limit";
 
 namespace{
 
@@ -52,6 +62,19 @@ void printUsage() {
         "-v                         Increase verbosity (can be applied multiple times)\n"
         "-i,--input <file>          Input file (option not required)\n"
         "--force-ts                 Enforces solving for a single TS (in case if there is a structure of TS, it is simplified into a single TS)\n"
+        "--time-limit <seconds>     Stop solving and answer unknown after the given wall-clock time\n"
+        "--memory-limit <MB>        Stop solving and answer unknown once the process uses more memory than given\n"
+        "--tpa.rebuild <policy>     When TPA rebuilds its incremental solvers; possible values: adaptive (default), never,\n"
+        "                           or a number of levels after which the solver is always rebuilt\n"
+        "--tpa.threads <n>          Number of threads split-TPA uses; the additional threads check the second half of a path\n"
+        "                           while the first half is being explored (default 1)\n"
+        "--tpa.cache-size <n>       Maximal number of reachability queries whose results TPA remembers (default 100000)\n"
+        "--tpa.network-threads <n>  Number of threads TPA uses for a network of transition systems; the additional threads\n"
+        "                           solve the other successors of a system while one successor is explored (default 1)\n"
+        "--spacer.push-threads <n>  Number of threads Spacer uses to push lemmas to the next level (default 1)\n"
+        "--kind.parallel            Run the base case and both induction checks of KIND in separate threads\n"
+        "--bmc.threads <n>          Number of threads BMC uses to check different depths (default 1)\n"
+        "--bmc.jump <s>             Number of consecutive depths BMC checks with a single query (default 1)\n"
         ;
     std::cout << std::flush;
 }
@@ -71,8 +94,18 @@ Options CommandLineParser::parse(int argc, char ** argv) {
     int forcedCovering = 0;
     int verbose = 0;
     int tpaUseQE = 0;
+    int tpaRebuild = 0;
+    int tpaThreads = 0;
+    int tpaCacheSize = -1;
+    int tpaNetworkThreads = 0;
     int printVersion = 0;
     int forceTS = 0;
+    int timeLimit = 0;
+    int memoryLimit = 0;
+    int spacerPushThreads = 0;
+    int kindParallel = 0;
+    int bmcThreads = 0;
+    int bmcJump = 0;
 
     struct option long_options[] =
         {
@@ -89,8 +122,18 @@ Options CommandLineParser::parse(int argc, char ** argv) {
             {Options::FORCED_COVERING.c_str(), optional_argument, &forcedCovering, 1},
             {Options::VERBOSE.c_str(), optional_argument, &verbose, 1},
             {Options::TPA_USE_QE.c_str(), optional_argument, &tpaUseQE, 1},
+            {Options::TPA_REBUILD.c_str(), required_argument, &tpaRebuild, 0},
+            {Options::TPA_THREADS.c_str(), required_argument, &tpaThreads, 0},
+            {Options::TPA_CACHE_SIZE.c_str(), required_argument, &tpaCacheSize, 0},
+            {Options::TPA_NETWORK_THREADS.c_str(), required_argument, &tpaNetworkThreads, 0},
             {Options::PROOF_FORMAT.c_str(), required_argument, nullptr, 'p'},
             {Options::FORCE_TS.c_str(), no_argument, &forceTS, 1},
+            {Options::TIME_LIMIT.c_str(), required_argument, &timeLimit, 0},
+            {Options::MEMORY_LIMIT.c_str(), required_argument, &memoryLimit, 0},
+            {Options::SPACER_PUSH_THREADS.c_str(), required_argument, &spacerPushThreads, 0},
+            {Options::KIND_PARALLEL.c_str(), no_argument, &kindParallel, 1},
+            {Options::BMC_THREADS.c_str(), required_argument, &bmcThreads, 0},
+            {Options::BMC_JUMP.c_str(), required_argument, &bmcJump, 0},
             {0, 0, 0, 0}
         };
 
@@ -118,6 +161,18 @@ Options CommandLineParser::parse(int argc, char ** argv) {
                     }
                 } else if (long_options[option_index].flag == &tpaUseQE) {
                     tpaUseQE = 1;
+                } else if (long_options[option_index].flag == &tpaRebuild) {
+                    assert(optarg);
+                    res.addOption(Options::TPA_REBUILD, optarg);
+                } else if (long_options[option_index].flag == &tpaThreads) {
+                    assert(optarg);
+                    tpaThreads = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &tpaCacheSize) {
+                    assert(optarg);
+                    tpaCacheSize = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &tpaNetworkThreads) {
+                    assert(optarg);
+                    tpaNetworkThreads = std::atoi(optarg);
                 } else if (long_options[option_index].flag == &lraItpAlg) {
                     assert(optarg);
                     lraItpAlg = std::atoi(optarg);
@@ -127,6 +182,21 @@ Options CommandLineParser::parse(int argc, char ** argv) {
                     verbose = std::atoi(optarg);
                 } else if (long_options[option_index].flag == &forceTS) {
                     forceTS = 1;
+                } else if (long_options[option_index].flag == &timeLimit) {
+                    assert(optarg);
+                    timeLimit = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &memoryLimit) {
+                    assert(optarg);
+                    memoryLimit = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &spacerPushThreads) {
+                    assert(optarg);
+                    spacerPushThreads = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &bmcThreads) {
+                    assert(optarg);
+                    bmcThreads = std::atoi(optarg);
+                } else if (long_options[option_index].flag == &bmcJump) {
+                    assert(optarg);
+                    bmcJump = std::atoi(optarg);
                 }
                 break;
             case 'e':
@@ -178,9 +248,36 @@ Options CommandLineParser::parse(int argc, char ** argv) {
     if (tpaUseQE) {
         res.addOption(Options::TPA_USE_QE, "true");
     }
+    if (tpaThreads > 0) {
+        res.addOption(Options::TPA_THREADS, std::to_string(tpaThreads));
+    }
+    if (tpaCacheSize >= 0) {
+        res.addOption(Options::TPA_CACHE_SIZE, std::to_string(tpaCacheSize));
+    }
+    if (tpaNetworkThreads > 0) {
+        res.addOption(Options::TPA_NETWORK_THREADS, std::to_string(tpaNetworkThreads));
+    }
     if (forceTS) {
         res.addOption(Options::FORCE_TS, "true");
     }
+    if (timeLimit > 0) {
+        res.addOption(Options::TIME_LIMIT, std::to_string(timeLimit));
+    }
+    if (memoryLimit > 0) {
+        res.addOption(Options::MEMORY_LIMIT, std::to_string(memoryLimit));
+    }
+    if (spacerPushThreads > 0) {
+        res.addOption(Options::SPACER_PUSH_THREADS, std::to_string(spacerPushThreads));
+    }
+    if (kindParallel) {
+        res.addOption(Options::KIND_PARALLEL, "true");
+    }
+    if (bmcThreads > 0) {
+        res.addOption(Options::BMC_THREADS, std::to_string(bmcThreads));
+    }
+    if (bmcJump > 0) {
+        res.addOption(Options::BMC_JUMP, std::to_string(bmcJump));
+    }
     res.addOption(Options::LRA_ITP_ALG, std::to_string(lraItpAlg));
     res.addOption(Options::VERBOSE, std::to_string(verbose));
 
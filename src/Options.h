@@ -45,7 +45,17 @@ public:
     static const std::string FORCED_COVERING;
     static const std::string VERBOSE;
     static const std::string TPA_USE_QE;
+    static const std::string TPA_REBUILD;
+    static const std::string TPA_THREADS;
+    static const std::string TPA_CACHE_SIZE;
+    static const std::string TPA_NETWORK_THREADS;
+    static const std::string SPACER_PUSH_THREADS;
+    static const std::string KIND_PARALLEL;
+    static const std::string BMC_THREADS;
+    static const std::string BMC_JUMP;
     static const std::string FORCE_TS;
+    static const std::string TIME_LIMIT;
+    static const std::string MEMORY_LIMIT;
 };
 
 class CommandLineParser {
@@ -33,8 +33,8 @@ PTRef QuantifierElimination::eliminate(PTRef fla, vec<PTRef> const & vars) {
     fla = TermUtils(logic).toNNF(fla);
     vec<PTRef> projections;
 
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(fla);
     while(true) {
         auto res = solver.check();
@@ -492,6 +492,55 @@ void LATermUtils::simplifyConjunction(std::vector<PtAsgn> & conjuncts) {
     simplifyJunction<Conjunction>(conjuncts, logic);
 }
 
+TimeMachine::VersionedVar TimeMachine::lookup(PTRef var) const {
+    auto it = versionOf.find(var);
+    if (it != versionOf.end()) { return it->second; }
+    // First encounter of the variable: parse its name and register it in the table of its versions
+    std::string varName = logic.getSymName(var);
+    auto pos = varName.rfind(versionSeparator);
+    int version = std::stoi(varName.substr(pos + versionSeparator.size()));
+    varName.erase(pos);
+    SRef sort = logic.getSortRef(var);
+    PTRef versionZero = version == 0 ? var : logic.mkVar(sort, (varName + versionSeparator + '0').c_str());
+    auto tableIt = versionTables.find(versionZero);
+    if (tableIt == versionTables.end()) {
+        tableIt = versionTables.insert({versionZero, VersionTable{varName, sort, PTRef_Undef, {versionZero}}}).first;
+        versionOf.insert({versionZero, VersionedVar{versionZero, 0}});
+    }
+    auto & versions = tableIt->second.versions;
+    if (version >= 0) {
+        if (versions.size() <= static_cast<std::size_t>(version)) { versions.resize(version + 1, PTRef_Undef); }
+        versions[version] = var;
+    }
+    VersionedVar versioned{versionZero, version};
+    versionOf.insert({var, versioned});
+    return versioned;
+}
+
+PTRef TimeMachine::getVersion(VersionTable & table, int version) const {
+    auto & versions = table.versions;
+    if (version >= 0 and static_cast<std::size_t>(version) < versions.size() and versions[version] != PTRef_Undef) {
+        return versions[version];
+    }
+    std::string name = table.unversionedName + versionSeparator + std::to_string(version);
+    PTRef var = logic.mkVar(table.sort, name.c_str());
+    if (version >= 0) {
+        if (versions.size() <= static_cast<std::size_t>(version)) { versions.resize(version + 1, PTRef_Undef); }
+        versions[version] = var;
+    }
+    versionOf.insert({var, VersionedVar{versions[0], version}});
+    return var;
+}
+
+PTRef UnrollingCache::getVersion(PTRef fla, unsigned steps) {
+    auto & flaVersions = versions[fla];
+    if (flaVersions.empty()) { flaVersions.push_back(fla); }
+    while (flaVersions.size() <= steps) {
+        flaVersions.push_back(timeMachine.sendFlaThroughTime(fla, static_cast<int>(flaVersions.size())));
+    }
+    return flaVersions[steps];
+}
+
 PTRef TimeMachine::versionedFormulaToUnversioned(PTRef fla) const {
     class Config : public DefaultRewriterConfig {
         Logic const & logic;
@@ -605,32 +654,73 @@ void VersionManager::removeTag(std::string & varName) {
     varName.erase(pos);
 }
 
+PTRef VersionManager::toBase(PTRef var) const {
+    assert(logic.isVar(var));
+    if (auto it = baseOf.find(var); it != baseOf.end()) { return it->second; }
+    std::string varName = logic.getSymName(var);
+    ensureNoVersion(varName);
+    removeTag(varName);
+    PTRef base = logic.mkVar(logic.getSortRef(var), varName.c_str());
+    baseOf.emplace(var, base);
+    return base;
+}
+
+PTRef VersionManager::toSource(PTRef var, unsigned instance) const {
+    assert(logic.isVar(var));
+    assert(not isVersioned(var));
+    auto & sources = versionsOf[var].sources;
+    if (sources.size() <= instance) { sources.resize(instance + 1, PTRef_Undef); }
+    if (sources[instance] == PTRef_Undef) {
+        std::stringstream ss;
+        ss << logic.getSymName(var) << tagSeparator << sourceSuffix << instanceSeparator << instance;
+        std::string newName = ss.str();
+        sources[instance] = logic.mkVar(logic.getSortRef(var), newName.c_str());
+        baseOf.emplace(sources[instance], var);
+    }
+    return sources[instance];
+}
+
+PTRef VersionManager::toTarget(PTRef var) const {
+    assert(logic.isVar(var));
+    assert(not isVersioned(var));
+    assert(not isTagged(var));
+    auto & versions = versionsOf[var];
+    if (versions.target == PTRef_Undef) {
+        std::stringstream ss;
+        ss << logic.getSymName(var) << tagSeparator << targetSuffix;
+        std::string newName = ss.str();
+        versions.target = logic.mkVar(logic.getSortRef(var), newName.c_str());
+        baseOf.emplace(versions.target, var);
+    }
+    return versions.target;
+}
+
 PTRef VersionManager::baseFormulaToSource(PTRef fla, unsigned int instance) const {
-    return rewrite(fla, [instance, this](PTRef var) {
+    return cachedRewrite(fla, Transform::BASE_TO_SOURCE, instance, [instance, this](PTRef var) {
        return toSource(var, instance);
     });
 }
 
 PTRef VersionManager::baseFormulaToTarget(PTRef fla) const {
-    return rewrite(fla, [this](PTRef var) {
+    return cachedRewrite(fla, Transform::BASE_TO_TARGET, 0, [this](PTRef var) {
         return toTarget(var);
     });
 }
 
 PTRef VersionManager::sourceFormulaToBase(PTRef fla) const {
-    return rewrite(fla, [this](PTRef var) {
+    return cachedRewrite(fla, Transform::TO_BASE, 0, [this](PTRef var) {
         return toBase(var);
     });
 }
 
 PTRef VersionManager::targetFormulaToBase(PTRef fla) const {
-    return rewrite(fla, [this](PTRef var) {
+    return cachedRewrite(fla, Transform::TO_BASE, 0, [this](PTRef var) {
         return toBase(var);
     });
 }
 
 PTRef VersionManager::sourceFormulaToTarget(PTRef fla) const {
-    return rewrite(fla, [this](PTRef var) {
+    return cachedRewrite(fla, Transform::SOURCE_TO_TARGET, 0, [this](PTRef var) {
         return toTarget(toBase(var));
     });
 }
\ No newline at end of file
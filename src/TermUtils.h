@@ -11,7 +11,11 @@
 
 #include <algorithm>
 #include <iostream>
+#include <list>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class TermUtils {
     Logic & logic;
@@ -187,10 +191,35 @@ public:
     void simplifyConjunction(std::vector<PtAsgn> & disjuncts);
 };
 
+/**
+ * Versioning of state variables for unrolling of transition relations: x##0 is the current state, x##1 the next state...
+ *
+ * Each instance remembers the variables it has seen, indexed by their version zero and their version number. Names
+ * are parsed and built only the first time a variable or a version is encountered; afterwards, moving a variable
+ * through time is a table lookup. Engines should therefore keep one instance for their whole run.
+ */
 class TimeMachine {
     Logic & logic;
     const std::string versionSeparator = "##";
 
+    struct VersionedVar {
+        PTRef versionZero;
+        int version;
+    };
+
+    struct VersionTable {
+        std::string unversionedName;
+        SRef sort;
+        PTRef unversioned = PTRef_Undef;
+        std::vector<PTRef> versions; // Indexed by the version number
+    };
+
+    mutable std::unordered_map<PTRef, VersionedVar, PTRefHash> versionOf;
+    mutable std::unordered_map<PTRef, VersionTable, PTRefHash> versionTables; // Indexed by version zero
+
+    VersionedVar lookup(PTRef var) const;
+    PTRef getVersion(VersionTable & table, int version) const;
+
     class VersioningConfig : public DefaultRewriterConfig {
         TimeMachine & owner;
         Logic const & logic;
@@ -221,14 +250,8 @@ public:
     [[nodiscard]] PTRef sendVarThroughTime(PTRef var, int steps) const {
         assert(logic.isVar(var));
         assert(isVersioned(var));
-        std::string varName = logic.getSymName(var);
-        auto pos = varName.rfind(versionSeparator);
-        auto numPos = pos + versionSeparator.size();
-        auto numStr = varName.substr(numPos);
-        int version = std::stoi(numStr);
-        version += steps;
-        varName.replace(numPos, std::string::npos, std::to_string(version));
-        return logic.mkVar(logic.getSortRef(var), varName.c_str());
+        auto versioned = lookup(var);
+        return getVersion(versionTables.at(versioned.versionZero), versioned.version + steps);
     }
 
     // Given a variable with no version, compute the zero version representing current state
@@ -253,31 +276,23 @@ public:
     [[nodiscard]] PTRef getUnversioned(PTRef var) const {
         assert(logic.isVar(var));
         assert(isVersioned(var));
-        SRef sort = logic.getSortRef(var);
-        std::string varName = logic.getSymName(var);
-        auto pos = varName.rfind(versionSeparator);
-        varName.erase(pos);
-        return logic.mkVar(sort, varName.c_str());
+        auto & table = versionTables.at(lookup(var).versionZero);
+        if (table.unversioned == PTRef_Undef) {
+            table.unversioned = logic.mkVar(table.sort, table.unversionedName.c_str());
+        }
+        return table.unversioned;
     }
 
     [[nodiscard]] std::string getUnversionedName(PTRef var) const {
         assert(logic.isVar(var));
         assert(isVersioned(var));
-        std::string varName = logic.getSymName(var);
-        auto pos = varName.rfind(versionSeparator);
-        varName.erase(pos);
-        return varName;
+        return versionTables.at(lookup(var).versionZero).unversionedName;
     }
 
     [[nodiscard]] int getVersionNumber(PTRef var) const {
         assert(logic.isVar(var));
         assert(isVersioned(var));
-        std::string varName = logic.getSymName(var);
-        auto pos = varName.rfind(versionSeparator);
-        auto numPos = pos + versionSeparator.size();
-        auto numStr = varName.substr(numPos);
-        int version = std::stoi(numStr);
-        return version;
+        return lookup(var).version;
     }
 
     PTRef sendFlaThroughTime(PTRef fla, int steps) {
@@ -294,6 +309,7 @@ public:
 
     [[nodiscard]] bool isVersioned(PTRef var) const {
         assert(logic.isVar(var));
+        if (versionOf.find(var) != versionOf.end()) { return true; }
         std::string varName = logic.getSymName(var);
         return isVersionedName(varName);
     }
@@ -301,6 +317,21 @@ public:
     [[nodiscard]] PTRef versionedFormulaToUnversioned(PTRef fla) const;
 };
 
+/*
+ * Time-shifted copies of formulas, built on demand.
+ * Engines that unroll the same formulas to increasing depths obtain each copy only once.
+ */
+class UnrollingCache {
+    TimeMachine timeMachine;
+    std::unordered_map<PTRef, std::vector<PTRef>, PTRefHash> versions; // Indexed by the number of steps
+
+public:
+    explicit UnrollingCache(Logic & logic) : timeMachine(logic) {}
+
+    // Returns the formula sent 'steps' steps into the future
+    PTRef getVersion(PTRef fla, unsigned steps);
+};
+
 class VersionManager {
     Logic & logic;
     inline static const char sourceSuffix = 's';
@@ -311,6 +342,42 @@ class VersionManager {
     static void ensureNoVersion(std::string & varName);
     static void removeTag(std::string & varName);
 
+    /*
+     * Versions of variables and rewritten formulas are remembered, so that repeated versioning of the same lemma or
+     * summary does not need to build variable names or traverse the formula again. The variables are bounded by the
+     * system, but the formulas are not: only the most recently used rewrites are kept.
+     */
+    struct VarVersions {
+        PTRef target = PTRef_Undef;
+        std::vector<PTRef> sources; // Indexed by the instance
+    };
+
+    enum class Transform : char { BASE_TO_SOURCE, BASE_TO_TARGET, TO_BASE, SOURCE_TO_TARGET };
+
+    struct RewriteKey {
+        PTRef fla;
+        Transform transform;
+        unsigned instance;
+
+        bool operator==(RewriteKey const & other) const {
+            return fla == other.fla and transform == other.transform and instance == other.instance;
+        }
+    };
+
+    struct RewriteKeyHash {
+        std::size_t operator()(RewriteKey const & key) const {
+            return PTRefHash{}(key.fla) ^ (static_cast<std::size_t>(key.transform) << 1) ^
+                   (static_cast<std::size_t>(key.instance) << 3);
+        }
+    };
+
+    mutable std::unordered_map<PTRef, PTRef, PTRefHash> baseOf;
+    mutable std::unordered_map<PTRef, VarVersions, PTRefHash> versionsOf; // Indexed by the base variable
+    static constexpr std::size_t maxRewrites = 10000;
+    using RecentRewrites = std::list<std::pair<RewriteKey, PTRef>>; // The most recently used first
+    mutable RecentRewrites recentRewrites;
+    mutable std::unordered_map<RewriteKey, RecentRewrites::iterator, RewriteKeyHash> rewrites;
+
     template<typename TVarTransform>
     class VersioningConfig : public DefaultRewriterConfig {
         Logic const & logic;
@@ -338,8 +405,29 @@ class VersionManager {
         return VersioningRewriter<TVarTransform>(logic, config).rewrite(fla);
     }
 
+    template<typename TVarTransform>
+    PTRef cachedRewrite(PTRef fla, Transform transform, unsigned instance, TVarTransform varTransform) const {
+        RewriteKey key{fla, transform, instance};
+        if (auto it = rewrites.find(key); it != rewrites.end()) {
+            recentRewrites.splice(recentRewrites.begin(), recentRewrites, it->second);
+            return it->second->second;
+        }
+        PTRef result = rewrite(fla, varTransform);
+        recentRewrites.emplace_front(key, result);
+        rewrites.emplace(key, recentRewrites.begin());
+        if (rewrites.size() > maxRewrites) {
+            rewrites.erase(recentRewrites.back().first);
+            recentRewrites.pop_back();
+        }
+        return result;
+    }
+
 public:
     VersionManager(Logic & logic) : logic(logic) {}
+    // The cached rewrites refer into their own list, so a copy starts without them
+    VersionManager(VersionManager const & other)
+        : logic(other.logic), baseOf(other.baseOf), versionsOf(other.versionsOf) {}
+    VersionManager(VersionManager &&) = default;
 
     PTRef baseFormulaToTarget(PTRef fla) const;
     PTRef baseFormulaToSource(PTRef fla, unsigned instance = 0) const;
@@ -347,34 +435,9 @@ public:
     PTRef sourceFormulaToBase(PTRef fla) const;
     PTRef sourceFormulaToTarget(PTRef fla) const;
 
-    PTRef toBase(PTRef var) const {
-        assert(logic.isVar(var));
-        std::string varName = logic.getSymName(var);
-        ensureNoVersion(varName);
-        removeTag(varName);
-        return logic.mkVar(logic.getSortRef(var), varName.c_str());
-    }
-
-    PTRef toSource(PTRef var, unsigned instance = 0) const {
-        assert(logic.isVar(var));
-        assert(not isVersioned(var));
-        SRef sort = logic.getSortRef(var);
-        std::stringstream ss;
-        ss << logic.getSymName(var) << tagSeparator << sourceSuffix << instanceSeparator << instance;
-        std::string newName = ss.str();
-        return logic.mkVar(sort, newName.c_str());
-    }
-
-    PTRef toTarget(PTRef var) const {
-        assert(logic.isVar(var));
-        assert(not isVersioned(var));
-        assert(not isTagged(var));
-        SRef sort = logic.getSortRef(var);
-        std::stringstream ss;
-        ss << logic.getSymName(var) << tagSeparator << targetSuffix;
-        std::string newName = ss.str();
-        return logic.mkVar(sort, newName.c_str());
-    }
+    PTRef toBase(PTRef var) const;
+    PTRef toSource(PTRef var, unsigned instance = 0) const;
+    PTRef toTarget(PTRef var) const;
 
     static auto versionPosition(std::string const & name) {
         return name.rfind(instanceSeparator);
@@ -206,8 +206,8 @@ PTRef kinductiveToInductive(PTRef invariant, unsigned long k, TransitionSystem c
     vec<PTRef> helpers;
     helpers.push(PTRef_Undef);
     PTRef transition = system.getTransition();
-    auto getNextVersion = [&logic](PTRef fla, int shift) {
-        return TimeMachine(logic).sendFlaThroughTime(fla, shift);
+    auto getNextVersion = [&system](PTRef fla, unsigned long shift) {
+        return system.getUnrollings().getVersion(fla, shift);
     };
     auto getStateVars = [&logic, &stateVars](int version) {
         vec<PTRef> versioned;
@@ -8,6 +8,7 @@
 #ifndef GOLEM_TRANSITIONSYSTEM_H
 #define GOLEM_TRANSITIONSYSTEM_H
 
+#include "TermUtils.h"
 #include "osmt_terms.h"
 
 #include <vector>
@@ -47,6 +48,8 @@ class TransitionSystem {
     PTRef transition;
     PTRef query;
 
+    // Shared by all computations over this system; the cache lives on the heap so that moving the system keeps it valid
+    std::unique_ptr<UnrollingCache> unrollings;
 
 public:
     TransitionSystem(Logic & logic, std::unique_ptr<SystemType> systemType,
@@ -55,7 +58,8 @@ public:
         systemType(std::move(systemType)),
         init(initialStates),
         transition(transitionRelation),
-        query(badStates)
+        query(badStates),
+        unrollings(std::make_unique<UnrollingCache>(logic))
     {
         if (not isWellFormed()) {
             throw std::logic_error("Transition system not created correctly");
@@ -68,6 +72,9 @@ public:
 
     Logic & getLogic() const;
 
+    // Time-shifted copies of the formulas of this system (or of any other formula over its variables)
+    UnrollingCache & getUnrollings() const { return *unrollings; }
+
     std::vector<PTRef> getStateVars() const;
     std::vector<PTRef> getNextStateVars() const;
     std::vector<PTRef> getAuxiliaryVars() const;
@@ -65,8 +65,8 @@ Validator::Result Validator::validateValidityWitness(ChcDirectedHyperGraph const
         if (interpretedHead == PTRef_Undef) { return Result::NOT_VALIDATED; }
         PTRef query = logic.mkAnd(interpretedBody, logic.mkNot(interpretedHead));
         {
-            SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-            auto & solver = solverWrapper.getCoreSolver();
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
             solver.insertFormula(query);
             auto res = solver.check();
             if (res != s_False) {
@@ -110,8 +110,8 @@ Validator::Result validateStep(
     PTRef constraintAfterSubstitution = utils.varSubstitute(graph.getEdgeLabel(edge), subst);
     if (constraintAfterSubstitution == logic.getTerm_true()) { return Validator::Result::VALIDATED; }
     if (constraintAfterSubstitution == logic.getTerm_false()) { return Validator::Result::NOT_VALIDATED; }
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(constraintAfterSubstitution);
     auto res = solver.check();
     if (res == s_True) { return Validator::Result::VALIDATED; }
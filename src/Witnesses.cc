@@ -55,8 +55,8 @@ InvalidityWitness InvalidityWitness::fromErrorPath(ErrorPath const & errorPath,
     auto edgeIds = path.getEdges();
     // Compute model for the error path
     auto model = [&]() {
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+        auto & solver = solverWrapper->getCoreSolver();
         for (std::size_t i = 0; i < edgeIds.size(); ++i) {
             PTRef fla = graph.getEdgeLabel(edgeIds[i]);
             fla = TimeMachine(logic).sendFlaThroughTime(fla, i);
@@ -12,6 +12,12 @@
 #include "TransformationUtils.h"
 #include "transformers/SingleLoopTransformation.h"
 #include "utils/SmtSolver.h"
+#include "utils/TermTranslator.h"
+
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 VerificationResult BMC::solve(ChcDirectedGraph const & graph) {
     if (isTrivial(graph)) {
@@ -25,16 +31,30 @@ VerificationResult BMC::solve(ChcDirectedGraph const & graph) {
     auto[ts, backtranslator] = transformation.transform(graph);
     assert(ts);
     auto res = solveTransitionSystemInternal(*ts);
+    if (isInterrupted(res)) { return interrupted(res); }
     return backtranslator->translate(res);
 }
 
 VerificationResult BMC::solveTransitionSystem(ChcDirectedGraph const & graph) {
     auto ts = toTransitionSystem(graph);
     auto res = solveTransitionSystemInternal(*ts);
+    if (isInterrupted(res)) { return interrupted(res); }
     return translateTransitionSystemResult(res, graph, *ts);
 }
 
+bool BMC::isInterrupted(TransitionSystemVerificationResult const & result) const {
+    return result.answer == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested();
+}
+
+VerificationResult BMC::interrupted(TransitionSystemVerificationResult const & result) const {
+    auto depth = std::get<std::size_t>(result.witness);
+    return interruptedResult(cancellationToken, "BMC: No path of length smaller than " + std::to_string(depth));
+}
+
 TransitionSystemVerificationResult BMC::solveTransitionSystemInternal(TransitionSystem const & system) {
+    if (auto * arithLogic = dynamic_cast<ArithLogic *>(&logic); arithLogic and (threads > 1 or jump > 1)) {
+        return solveTransitionSystemWithWorkers(system, *arithLogic);
+    }
     std::size_t maxLoopUnrollings = std::numeric_limits<std::size_t>::max();
     PTRef init = system.getInit();
     PTRef query = system.getQuery();
@@ -51,13 +71,19 @@ TransitionSystemVerificationResult BMC::solveTransitionSystemInternal(Transition
         }
     }
 
-    TimeMachine tm{logic};
+    auto & unrollings = system.getUnrollings();
     for (std::size_t currentUnrolling = 0; currentUnrolling < maxLoopUnrollings; ++currentUnrolling) {
-        PTRef versionedQuery = tm.sendFlaThroughTime(query, currentUnrolling);
+        if (cancellationToken.stopRequested()) {
+            return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, currentUnrolling};
+        }
+        PTRef versionedQuery = unrollings.getVersion(query, currentUnrolling);
 //        std::cout << "Adding query: " << logic.pp(versionedQuery) << std::endl;
         solver.push();
         solver.insertFormula(versionedQuery);
         auto res = solver.check();
+        if (res == s_Undef and cancellationToken.stopRequested()) {
+            return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, currentUnrolling};
+        }
         if (res == s_True) {
             if (verbosity > 0) {
                 std::cout << "; BMC: Bug found in depth: " << currentUnrolling << std::endl;
@@ -68,9 +94,150 @@ TransitionSystemVerificationResult BMC::solveTransitionSystemInternal(Transition
             std::cout << "; BMC: No path of length " << currentUnrolling << " found!" << std::endl;
         }
         solver.pop();
-        PTRef versionedTransition = tm.sendFlaThroughTime(transition, currentUnrolling);
+        PTRef versionedTransition = unrollings.getVersion(transition, currentUnrolling);
 //        std::cout << "Adding transition: " << logic.pp(versionedTransition) << std::endl;
         solver.insertFormula(versionedTransition);
     }
     return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, 0u};
 }
+
+namespace { // Helpers for BMC::solveTransitionSystemWithWorkers
+// The term store is not thread-safe, so each worker unrolls the system in its own logic
+struct BmcWorker {
+    ArithLogic logic;
+    TermTranslator translator;
+    UnrollingCache unrollings;
+
+    explicit BmcWorker(ArithLogic & source)
+        : logic(source.hasIntegers() ? opensmt::Logic_t::QF_LIA : opensmt::Logic_t::QF_LRA),
+          translator(source, logic), unrollings(logic) {}
+};
+
+/*
+ * Windows of consecutive depths are handed out to the workers in increasing order. Every window before the earliest
+ * window still being checked has been checked completely.
+ */
+class BmcProgress {
+    std::mutex mutex;
+    std::size_t nextWindow = 0;
+    std::vector<std::size_t> currentWindows;
+    std::optional<std::size_t> counterexampleDepth;
+
+public:
+    CancellationToken const workersToken;
+
+    BmcProgress(std::size_t workers, CancellationToken workersToken)
+        : currentWindows(workers, 0), workersToken(std::move(workersToken)) {}
+
+    std::size_t claimWindow(std::size_t worker) {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentWindows[worker] = nextWindow++;
+        return currentWindows[worker];
+    }
+
+    void reportCounterexample(std::size_t depth) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (not counterexampleDepth.has_value() or depth < counterexampleDepth.value()) { counterexampleDepth = depth; }
+        }
+        workersToken.requestStop();
+    }
+
+    std::optional<std::size_t> getCounterexampleDepth() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counterexampleDepth;
+    }
+
+    std::size_t checkedWindows() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return *std::min_element(currentWindows.begin(), currentWindows.end());
+    }
+};
+
+void checkWindows(BmcWorker & worker, std::size_t index, BmcProgress & progress, std::size_t windowSize,
+                  TransitionSystem const & system) {
+    Logic & logic = worker.logic;
+    auto & unrollings = worker.unrollings;
+    PTRef transition = worker.translator.translate(system.getTransition());
+    PTRef query = worker.translator.translate(system.getQuery());
+    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper.getCoreSolver();
+    solver.insertFormula(worker.translator.translate(system.getInit()));
+    std::size_t unrolled = 0;
+    while (not progress.workersToken.stopRequested()) {
+        std::size_t first = progress.claimWindow(index) * windowSize;
+        std::size_t last = first + windowSize - 1;
+        for (; unrolled < first; ++unrolled) {
+            solver.insertFormula(unrollings.getVersion(transition, unrolled));
+        }
+        // Some depth of the window reaches the query; transitions after that depth need not exist
+        PTRef reachesQuery = unrollings.getVersion(query, last);
+        for (std::size_t depth = last; depth-- > first;) {
+            reachesQuery = logic.mkOr(unrollings.getVersion(query, depth),
+                                      logic.mkAnd(unrollings.getVersion(transition, depth), reachesQuery));
+        }
+        solver.push();
+        solver.insertFormula(reachesQuery);
+        auto res = solver.check();
+        if (res == s_True) {
+            auto model = solver.getModel();
+            std::size_t depth = first;
+            while (depth < last and model->evaluate(unrollings.getVersion(query, depth)) != logic.getTerm_true()) {
+                ++depth;
+            }
+            progress.reportCounterexample(depth);
+            return;
+        }
+        if (res != s_False) { return; }
+        solver.pop();
+    }
+}
+} // namespace
+
+/*
+ * Several workers check windows of consecutive depths, each with its own incremental solver; a window is decided by a
+ * single query. The first counterexample found stops all workers. The workers only read the terms of this engine's
+ * logic while they run.
+ */
+TransitionSystemVerificationResult BMC::solveTransitionSystemWithWorkers(TransitionSystem const & system,
+                                                                        ArithLogic & arithLogic) {
+    { // Check for system with empty initial states
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        solverWrapper->getCoreSolver().insertFormula(system.getInit());
+        if (solverWrapper->getCoreSolver().check() == s_False) {
+            return TransitionSystemVerificationResult{VerificationAnswer::SAFE, logic.getTerm_false()};
+        }
+    }
+    BmcProgress progress(threads, cancellationToken.createChild());
+    std::vector<std::unique_ptr<BmcWorker>> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.push_back(std::make_unique<BmcWorker>(arithLogic));
+    }
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workerThreads;
+    workerThreads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workerThreads.emplace_back([&, i]() {
+            CancellationToken::Scope scope(progress.workersToken);
+            try {
+                checkWindows(*workers[i], i, progress, jump, system);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                progress.workersToken.requestStop();
+            }
+        });
+    }
+    for (auto & thread : workerThreads) {
+        thread.join();
+    }
+    for (auto const & error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+    if (auto depth = progress.getCounterexampleDepth(); depth.has_value()) {
+        if (verbosity > 0) {
+            std::cout << "; BMC: Bug found in depth: " << depth.value() << std::endl;
+        }
+        return TransitionSystemVerificationResult{.answer = VerificationAnswer::UNSAFE, .witness = depth.value()};
+    }
+    return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, progress.checkedWindows() * jump};
+}
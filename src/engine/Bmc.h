@@ -10,14 +10,20 @@
 #include "Engine.h"
 #include "TransitionSystem.h"
 
+#include <algorithm>
+
 class BMC : public Engine {
     Logic & logic;
 //    Options const & options;
     int verbosity = 0;
+    std::size_t threads = 1;
+    std::size_t jump = 1;
 public:
 
     BMC(Logic & logic, Options const & options) : logic(logic) {
         verbosity = std::stoi(options.getOrDefault(Options::VERBOSE, "0"));
+        threads = std::max<std::size_t>(1, std::stoul(options.getOrDefault(Options::BMC_THREADS, "1")));
+        jump = std::max<std::size_t>(1, std::stoul(options.getOrDefault(Options::BMC_JUMP, "1")));
     }
 
     virtual VerificationResult solve(ChcDirectedHyperGraph const & graph) override {
@@ -33,6 +39,11 @@ public:
 private:
     VerificationResult solveTransitionSystem(ChcDirectedGraph const & graph);
     TransitionSystemVerificationResult solveTransitionSystemInternal(TransitionSystem const & system);
+    TransitionSystemVerificationResult solveTransitionSystemWithWorkers(TransitionSystem const & system,
+                                                                        ArithLogic & arithLogic);
+
+    bool isInterrupted(TransitionSystemVerificationResult const & result) const;
+    VerificationResult interrupted(TransitionSystemVerificationResult const & result) const;
 };
 
 
@@ -11,8 +11,8 @@ VerificationResult solveTrivial(ChcDirectedGraph const & graph) {
         assert(graph.getTarget(eid) == graph.getExit());
         PTRef label = graph.getEdgeLabel(eid);
         if (label == logic.getTerm_false()) { continue; }
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         solver.insertFormula(label);
         auto res = solver.check();
         if (res == s_False) {
@@ -34,3 +34,7 @@ VerificationResult solveTrivial(ChcDirectedGraph const & graph) {
     // Here we know that no edge is satisfiable
     return VerificationResult(VerificationAnswer::SAFE, ValidityWitness{});
 }
+
+VerificationResult interruptedResult(CancellationToken const & token, std::string const & progress) {
+    return VerificationResult(VerificationAnswer::UNKNOWN, NoWitness("Stopped (" + token.describeStop() + "); " + progress));
+}
@@ -3,7 +3,14 @@
 
 #include "Witnesses.h"
 #include "graph/ChcGraph.h"
+#include "utils/CancellationToken.h"
 
 VerificationResult solveTrivial(ChcDirectedGraph const & graph);
 
+/**
+ * Result of an engine that gave up because it has been cancelled or it has exhausted its budget.
+ * The reason for the missing witness says why the engine stopped and how far it got.
+ */
+VerificationResult interruptedResult(CancellationToken const & token, std::string const & progress);
+
 #endif // GOLEM_COMMON_H
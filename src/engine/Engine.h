@@ -10,6 +10,8 @@
 #include "Witnesses.h"
 #include "Options.h"
 #include "graph/ChcGraph.h"
+#include "utils/CancellationToken.h"
+#include "utils/LemmaBus.h"
 
 #include "osmt_terms.h"
 
@@ -21,7 +23,21 @@ public:
         return VerificationResult(VerificationAnswer::UNKNOWN);
     }
 
+    /**
+     * Engines periodically check the token in their main loop and give up with UNKNOWN once a stop has been requested.
+     */
+    void setCancellationToken(CancellationToken token) { cancellationToken = std::move(token); }
+
+    /**
+     * Engines supporting it exchange proven facts with other engines of the portfolio through the bus.
+     */
+    void setLemmaBus(LemmaBus * bus) { lemmaBus = bus; }
+
     virtual ~Engine() = default;
+
+protected:
+    CancellationToken cancellationToken;
+    LemmaBus * lemmaBus = nullptr;
 };
 
 #endif //OPENSMT_ENGINE_H
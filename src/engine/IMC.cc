@@ -20,12 +20,14 @@ VerificationResult IMC::solve(ChcDirectedGraph const & graph) {
     auto [ts, backtranslator] = transformation.transform(graph);
     assert(ts);
     auto res = solveTransitionSystemInternal(*ts);
+    if (isInterrupted(res)) { return interrupted(res); }
     return computeWitness ? backtranslator->translate(res) : VerificationResult(res.answer);
 }
 
 VerificationResult IMC::solveTransitionSystem(ChcDirectedGraph const & graph) {
     auto ts = toTransitionSystem(graph);
     auto res = solveTransitionSystemInternal(*ts);
+    if (isInterrupted(res)) { return interrupted(res); }
     return computeWitness ? translateTransitionSystemResult(res, graph, *ts) : VerificationResult(res.answer);
 }
 
@@ -35,18 +37,43 @@ TransitionSystemVerificationResult IMC::solveTransitionSystemInternal(Transition
     SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
     solverWrapper.getConfig().setSimplifyInterpolant(4);
     auto & solver = solverWrapper.getCoreSolver();
-    TimeMachine tm{logic};
     solver.insertFormula(system.getInit());
     solver.insertFormula(system.getQuery());
     // if I /\ F is Satisfiable, return true
     if (solver.check() == s_True) { return TransitionSystemVerificationResult{VerificationAnswer::UNSAFE, 0u}; }
+    RunSolvers solvers(logic);
     for (uint32_t k = 1; k < maxLoopUnrollings; ++k) {
-        auto res = finiteRun(system, k);
+        // Extend the suffix T_1 ... T_{k-1} shared by the runs
+        if (k > 1) { solvers.insertIntoSuffix(system.getUnrollings().getVersion(system.getTransition(), k - 1)); }
+        auto res = finiteRun(system, k, solvers);
         if (res.answer != VerificationAnswer::UNKNOWN) { return res; }
+        if (cancellationToken.stopRequested()) {
+            return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, static_cast<std::size_t>(k)};
+        }
     }
     return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, 0u};
 }
 
+IMC::RunSolvers::RunSolvers(Logic & logic)
+    : suffix(logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS),
+      implication(logic, SMTSolver::WitnessProduction::NONE) {
+    suffix.getConfig().setSimplifyInterpolant(4);
+}
+
+std::size_t IMC::RunSolvers::insertIntoSuffix(PTRef fla) {
+    suffix.getCoreSolver().insertFormula(fla);
+    return insertedFormulas++;
+}
+
+bool IMC::isInterrupted(TransitionSystemVerificationResult const & result) const {
+    return result.answer == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested();
+}
+
+VerificationResult IMC::interrupted(TransitionSystemVerificationResult const & result) const {
+    auto k = std::holds_alternative<std::size_t>(result.witness) ? std::get<std::size_t>(result.witness) : 0;
+    return interruptedResult(cancellationToken, "IMC: Stopped in the run with lookahead " + std::to_string(k));
+}
+
 namespace { // Helper method for IMC::finiteRun
 PTRef lastIterationInterpolant(MainSolver & solver, ipartitions_t const & mask) {
     auto itpContext = solver.getInterpolationContext();
@@ -58,47 +85,51 @@ PTRef lastIterationInterpolant(MainSolver & solver, ipartitions_t const & mask)
 } // namespace
 
 // procedure FiniteRun(M=(I,T,F), k>0)
-TransitionSystemVerificationResult IMC::finiteRun(TransitionSystem const & ts, unsigned k) {
+TransitionSystemVerificationResult IMC::finiteRun(TransitionSystem const & ts, unsigned k, RunSolvers & solvers) {
     assert(k > 0);
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS);
-    solverWrapper.getConfig().setSimplifyInterpolant(4);
     TimeMachine tm{logic};
-    PTRef suffix = [&]() {
-        int lookahead = static_cast<int>(k);
-        vec<PTRef> suffixTransitions;
-        for (auto i = 1; i < lookahead; ++i) {
-            suffixTransitions.push(tm.sendFlaThroughTime(ts.getTransition(), i));
-        }
-        suffixTransitions.push(tm.sendFlaThroughTime(ts.getQuery(), lookahead));
-        return logic.mkAnd(std::move(suffixTransitions));
-    }();
-    solverWrapper.getCoreSolver().insertFormula(suffix);
-    PTRef movingInit = ts.getInit();
-    unsigned iter = 0;
-    while (true) {
-        auto & solver = solverWrapper.getCoreSolver();
-        solver.push();
-        PTRef prefix = logic.mkAnd(movingInit, ts.getTransition());
-        solver.insertFormula(prefix);
-        auto res = solver.check();
-        // if prefix + suffix is satisfiable
-        if (res == s_True) {
-            if (movingInit == ts.getInit()) {
-                // Real counterexample
-                return {VerificationAnswer::UNSAFE, iter + k};
-            } else {
-                // Possibly spurious counterexample => Abort and continue with larger k
-                return {VerificationAnswer::UNKNOWN, PTRef_Undef};
+    auto & solver = solvers.suffix.getCoreSolver();
+    // The suffix T_1 ... T_{k-1} is already asserted, only the query at its end belongs to this run
+    solver.push();
+    solvers.insertIntoSuffix(ts.getUnrollings().getVersion(ts.getQuery(), k));
+    auto & implicationSolver = solvers.implication;
+    implicationSolver.push();
+    implicationSolver.getCoreSolver().insertFormula(logic.mkNot(ts.getInit()));
+    auto result = [&]() -> TransitionSystemVerificationResult {
+        PTRef movingInit = ts.getInit();
+        unsigned iter = 0;
+        while (true) {
+            if (cancellationToken.stopRequested()) { return {VerificationAnswer::UNKNOWN, PTRef_Undef}; }
+            solver.push();
+            PTRef prefix = logic.mkAnd(movingInit, ts.getTransition());
+            auto prefixPartition = solvers.insertIntoSuffix(prefix);
+            auto res = solver.check();
+            PTRef itp = PTRef_Undef;
+            if (res == s_False) {
+                ipartitions_t mask = 0;
+                opensmt::setbit(mask, prefixPartition);
+                // let P = Itp(P, A, B)
+                itp = lastIterationInterpolant(solver, mask);
+            }
+            solver.pop();
+            if (res != s_True and res != s_False) { return {VerificationAnswer::UNKNOWN, PTRef_Undef}; }
+            // if prefix + suffix is satisfiable
+            if (res == s_True) {
+                if (movingInit == ts.getInit()) {
+                    // Real counterexample
+                    return {VerificationAnswer::UNSAFE, iter + k};
+                } else {
+                    // Possibly spurious counterexample => Abort and continue with larger k
+                    return {VerificationAnswer::UNKNOWN, PTRef_Undef};
+                }
             }
-        } else { // if prefix + suffix is unsatisfiable
-            ipartitions_t mask = 0;
-            opensmt::setbit(mask, iter + 1);
-            // let P = Itp(P, A, B)
+            // if prefix + suffix is unsatisfiable
             // let R' = P<W/W0>
-            PTRef itp = lastIterationInterpolant(solver, mask);
             itp = tm.sendFlaThroughTime(itp, -1);
             // if R' => R return False(if R' /\ not R returns True)
-            if (implies(itp, movingInit)) {
+            vec<PTRef> assumptions;
+            assumptions.push(implicationSolver.activationLiteral(itp));
+            if (implicationSolver.checkUnderAssumptions(assumptions) == s_False) {
                 if (not computeWitness) { return {VerificationAnswer::SAFE, PTRef_Undef}; }
                 PTRef inductiveInvariant = movingInit;
                 PTRef finalInductiveInvariant = computeFinalInductiveInvariant(inductiveInvariant, k, ts);
@@ -106,18 +137,13 @@ TransitionSystemVerificationResult IMC::finiteRun(TransitionSystem const & ts, u
             }
             // let R = R\/R'
             movingInit = logic.mkOr(movingInit, itp);
+            implicationSolver.getCoreSolver().insertFormula(logic.mkNot(itp));
+            iter++;
         }
-        iter++;
-        solver.pop();
-    }
-}
-
-bool IMC::implies(PTRef antecedent, PTRef consequent) const {
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    PTRef negated = logic.mkAnd(antecedent, logic.mkNot(consequent));
-    solverWrapper.getCoreSolver().insertFormula(negated);
-    auto res = solverWrapper.getCoreSolver().check();
-    return res == s_False;
+    }();
+    implicationSolver.pop();
+    solver.pop();
+    return result;
 }
 
 /**
@@ -133,8 +159,8 @@ bool IMC::implies(PTRef antecedent, PTRef consequent) const {
  * @return safe inductive invariant of the system
  */
 PTRef IMC::computeFinalInductiveInvariant(PTRef inductiveInvariant, unsigned k, TransitionSystem const & ts) {
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(inductiveInvariant);
     solver.insertFormula(ts.getQuery());
     auto res = solver.check();
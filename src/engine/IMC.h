@@ -11,6 +11,7 @@
 #include "Engine.h"
 #include "TransitionSystem.h"
 #include "osmt_solver.h"
+#include "utils/SmtSolver.h"
 
 class IMC : public Engine {
     Logic & logic;
@@ -38,11 +39,29 @@ private:
     VerificationResult solveTransitionSystem(ChcDirectedGraph const & graph);
     TransitionSystemVerificationResult solveTransitionSystemInternal(TransitionSystem const & system);
 
-    TransitionSystemVerificationResult finiteRun(TransitionSystem const & ts, unsigned k);
+    /*
+     * Solvers reused by the finite runs of all lookaheads.
+     * The suffix solver keeps the transitions of the suffix as the lookahead grows, only the query at its end is
+     * replaced. OpenSMT numbers the interpolation partitions by the order of insertion, popped formulas included.
+     * The implication solver holds the negation of the moving initial states of the current run.
+     */
+    struct RunSolvers {
+        SMTSolver suffix;
+        SMTSolver implication;
+        std::size_t insertedFormulas = 0;
+
+        explicit RunSolvers(Logic & logic);
+
+        // Returns the partition of the inserted formula
+        std::size_t insertIntoSuffix(PTRef fla);
+    };
+
+    TransitionSystemVerificationResult finiteRun(TransitionSystem const & ts, unsigned k, RunSolvers & solvers);
 
     PTRef computeFinalInductiveInvariant(PTRef inductiveInvariant, unsigned k, TransitionSystem const & ts);
 
-    bool implies(PTRef antecedent, PTRef consequent) const;
+    bool isInterrupted(TransitionSystemVerificationResult const & result) const;
+    VerificationResult interrupted(TransitionSystemVerificationResult const & result) const;
 };
 
 #endif // GOLEM_IMC_H
@@ -12,6 +12,13 @@
 #include "transformers/BasicTransformationPipelines.h"
 #include "TransformationUtils.h"
 #include "utils/SmtSolver.h"
+#include "utils/TermTranslator.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 VerificationResult Kind::solve(ChcDirectedHyperGraph const & graph) {
     auto pipeline = Transformations::towardsTransitionSystems();
@@ -39,10 +46,17 @@ VerificationResult Kind::solve(ChcDirectedGraph const & graph) {
 VerificationResult Kind::solveTransitionSystem(ChcDirectedGraph const & graph) {
     auto ts = toTransitionSystem(graph);
     auto res = solveTransitionSystemInternal(*ts);
+    if (res.answer == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested()) {
+        auto k = std::get<std::size_t>(res.witness);
+        return interruptedResult(cancellationToken, "KIND: No path of length smaller than " + std::to_string(k));
+    }
     return computeWitness ? translateTransitionSystemResult(res, graph, *ts) : VerificationResult(res.answer);
 }
 
 TransitionSystemVerificationResult Kind::solveTransitionSystemInternal(TransitionSystem const & system) {
+    if (auto * arithLogic = dynamic_cast<ArithLogic *>(&logic); arithLogic and parallel) {
+        return solveTransitionSystemInParallel(system, *arithLogic);
+    }
     std::size_t maxK = std::numeric_limits<std::size_t>::max();
     PTRef init = system.getInit();
     PTRef query = system.getQuery();
@@ -72,13 +86,17 @@ TransitionSystemVerificationResult Kind::solveTransitionSystemInternal(Transitio
         }
     }
 
-    TimeMachine tm{logic};
+    auto & unrollings = system.getUnrollings();
     for (std::size_t k = 0; k < maxK; ++k) {
-        PTRef versionedQuery = tm.sendFlaThroughTime(query, k);
+        if (cancellationToken.stopRequested()) { return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, k}; }
+        PTRef versionedQuery = unrollings.getVersion(query, k);
         // Base case
         solverBase.getCoreSolver().push();
         solverBase.getCoreSolver().insertFormula(versionedQuery);
         auto res = solverBase.getCoreSolver().check();
+        if (res == s_Undef and cancellationToken.stopRequested()) {
+            return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, k};
+        }
         if (res == s_True) {
             if (verbosity > 0) {
                  std::cout << "; KIND: Bug found in depth: " << k << std::endl;
@@ -93,7 +111,7 @@ TransitionSystemVerificationResult Kind::solveTransitionSystemInternal(Transitio
             std::cout << "; KIND: No path of length " << k << " found!" << std::endl;
         }
         solverBase.getCoreSolver().pop();
-        PTRef versionedTransition = tm.sendFlaThroughTime(transition, k);
+        PTRef versionedTransition = unrollings.getVersion(transition, k);
 //        std::cout << "Adding transition: " << logic.pp(versionedTransition) << std::endl;
         solverBase.getCoreSolver().insertFormula(versionedTransition);
 
@@ -109,10 +127,10 @@ TransitionSystemVerificationResult Kind::solveTransitionSystemInternal(Transitio
                 return TransitionSystemVerificationResult{VerificationAnswer::SAFE, logic.getTerm_true()};
             }
         }
-        PTRef versionedBackwardTransition = tm.sendFlaThroughTime(backwardTransition, k);
+        PTRef versionedBackwardTransition = unrollings.getVersion(backwardTransition, k);
         solverStepForward.getCoreSolver().push();
         solverStepForward.getCoreSolver().insertFormula(versionedBackwardTransition);
-        solverStepForward.getCoreSolver().insertFormula(tm.sendFlaThroughTime(negQuery,k+1));
+        solverStepForward.getCoreSolver().insertFormula(unrollings.getVersion(negQuery, k + 1));
 
         // step backward
         res = solverStepBackward.getCoreSolver().check();
@@ -128,11 +146,200 @@ TransitionSystemVerificationResult Kind::solveTransitionSystemInternal(Transitio
         }
         solverStepBackward.getCoreSolver().push();
         solverStepBackward.getCoreSolver().insertFormula(versionedTransition);
-        solverStepBackward.getCoreSolver().insertFormula(tm.sendFlaThroughTime(negInit, k+1));
+        solverStepBackward.getCoreSolver().insertFormula(unrollings.getVersion(negInit, k + 1));
     }
     return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, 0u};
 }
 
+namespace { // Helpers for Kind::solveTransitionSystemInParallel
+enum class KindFinding : char { NONE, COUNTEREXAMPLE, FORWARD_INDUCTION, BACKWARD_INDUCTION };
+
+/*
+ * Progress of the three checks of parallel KIND. The first finding wins and stops the remaining checks.
+ * An induction check succeeding for k can only be reported once the base case has excluded counterexamples of length k.
+ */
+struct KindProgress {
+    CancellationToken workersToken;
+    std::mutex mutex;
+    std::condition_variable baseAdvanced;
+    std::size_t baseDepth = 0; // There is no counterexample of length smaller than this
+    KindFinding finding = KindFinding::NONE;
+    std::size_t k = 0;
+
+    void report(KindFinding newFinding, std::size_t depth) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finding != KindFinding::NONE) { return; }
+            finding = newFinding;
+            k = depth;
+        }
+        baseAdvanced.notify_all();
+        workersToken.requestStop();
+    }
+
+    void baseChecked(std::size_t depth) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            baseDepth = depth + 1;
+        }
+        baseAdvanced.notify_all();
+    }
+
+    // Returns false if the checks have been stopped before the base case reached the given depth
+    bool waitForBase(std::size_t depth) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (baseDepth <= depth) {
+            if (finding != KindFinding::NONE or workersToken.stopRequested()) { return false; }
+            baseAdvanced.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        return true;
+    }
+};
+
+// The term store is not thread-safe, so each check works in its own logic
+struct KindWorker {
+    ArithLogic logic;
+    TermTranslator translator;
+    UnrollingCache unrollings;
+
+    explicit KindWorker(ArithLogic & source)
+        : logic(source.hasIntegers() ? opensmt::Logic_t::QF_LIA : opensmt::Logic_t::QF_LRA),
+          translator(source, logic), unrollings(logic) {}
+};
+} // namespace
+
+/*
+ * Runs the base case and the forward and backward induction checks each in its own thread, without waiting for each
+ * other between the values of k. The threads only read the terms of this engine's logic while they run.
+ */
+TransitionSystemVerificationResult Kind::solveTransitionSystemInParallel(TransitionSystem const & system,
+                                                                         ArithLogic & arithLogic) {
+    PTRef init = system.getInit();
+    PTRef query = system.getQuery();
+    PTRef transition = system.getTransition();
+    PTRef backwardTransition = TransitionSystem::reverseTransitionRelation(system);
+    { // Check for system with empty initial states
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        solverWrapper->getCoreSolver().insertFormula(init);
+        if (solverWrapper->getCoreSolver().check() == s_False) {
+            return TransitionSystemVerificationResult{VerificationAnswer::SAFE, logic.getTerm_false()};
+        }
+    }
+
+    KindProgress progress;
+    progress.workersToken = cancellationToken.createChild();
+
+    auto baseCase = [&](KindWorker & worker) {
+        SMTSolver solverWrapper(worker.logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper.getCoreSolver();
+        PTRef workerQuery = worker.translator.translate(query);
+        PTRef workerTransition = worker.translator.translate(transition);
+        solver.insertFormula(worker.translator.translate(init));
+        for (std::size_t k = 0; not progress.workersToken.stopRequested(); ++k) {
+            solver.push();
+            solver.insertFormula(worker.unrollings.getVersion(workerQuery, k));
+            auto res = solver.check();
+            if (res == s_True) {
+                progress.report(KindFinding::COUNTEREXAMPLE, k);
+                return;
+            }
+            if (res != s_False) { // Without the base case, the induction checks cannot conclude anything
+                progress.workersToken.requestStop();
+                return;
+            }
+            progress.baseChecked(k);
+            solver.pop();
+            solver.insertFormula(worker.unrollings.getVersion(workerTransition, k));
+        }
+    };
+
+    auto inductionStep = [&](KindWorker & worker, PTRef start, PTRef step, KindFinding finding) {
+        SMTSolver solverWrapper(worker.logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper.getCoreSolver();
+        PTRef workerStart = worker.translator.translate(start);
+        PTRef workerStep = worker.translator.translate(step);
+        PTRef negatedStart = worker.logic.mkNot(workerStart);
+        solver.insertFormula(workerStart);
+        for (std::size_t k = 0; not progress.workersToken.stopRequested(); ++k) {
+            auto res = solver.check();
+            if (res == s_False) {
+                if (progress.waitForBase(k)) { progress.report(finding, k); }
+                return;
+            }
+            if (res != s_True) { return; }
+            solver.insertFormula(worker.unrollings.getVersion(workerStep, k));
+            solver.insertFormula(worker.unrollings.getVersion(negatedStart, k + 1));
+        }
+    };
+
+    std::vector<std::function<void(KindWorker &)>> tasks;
+    tasks.emplace_back(baseCase);
+    tasks.emplace_back([&](KindWorker & worker) {
+        inductionStep(worker, query, backwardTransition, KindFinding::FORWARD_INDUCTION);
+    });
+    tasks.emplace_back([&](KindWorker & worker) {
+        inductionStep(worker, init, transition, KindFinding::BACKWARD_INDUCTION);
+    });
+    std::vector<std::unique_ptr<KindWorker>> workers;
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        workers.push_back(std::make_unique<KindWorker>(arithLogic));
+    }
+    std::vector<std::exception_ptr> errors(tasks.size());
+    std::vector<std::thread> threads;
+    threads.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            CancellationToken::Scope scope(progress.workersToken);
+            try {
+                tasks[i](*workers[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                progress.workersToken.requestStop();
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    for (auto const & error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+
+    std::size_t k = progress.k;
+    switch (progress.finding) {
+        case KindFinding::COUNTEREXAMPLE:
+            if (verbosity > 0) {
+                std::cout << "; KIND: Bug found in depth: " << k << std::endl;
+            }
+            if (computeWitness) {
+                return TransitionSystemVerificationResult{VerificationAnswer::UNSAFE, k};
+            } else {
+                return TransitionSystemVerificationResult{VerificationAnswer::UNSAFE, 0u};
+            }
+        case KindFinding::FORWARD_INDUCTION:
+            if (verbosity > 0) {
+                std::cout << "; KIND: Found invariant with forward induction, which is " << k << "-inductive" << std::endl;
+            }
+            if (computeWitness) {
+                return TransitionSystemVerificationResult{VerificationAnswer::SAFE, invariantFromForwardInduction(system, k)};
+            } else {
+                return TransitionSystemVerificationResult{VerificationAnswer::SAFE, logic.getTerm_true()};
+            }
+        case KindFinding::BACKWARD_INDUCTION:
+            if (verbosity > 0) {
+                std::cout << "; KIND: Found invariant with backward induction, which is " << k << "-inductive" << std::endl;
+            }
+            if (computeWitness) {
+                return TransitionSystemVerificationResult{VerificationAnswer::SAFE, invariantFromBackwardInduction(system, k)};
+            } else {
+                return TransitionSystemVerificationResult{VerificationAnswer::SAFE, logic.getTerm_true()};
+            }
+        case KindFinding::NONE:
+            break;
+    }
+    return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, progress.baseDepth};
+}
+
 PTRef Kind::invariantFromForwardInduction(TransitionSystem const & transitionSystem, unsigned long k) const {
     PTRef kinductiveInvariant = logic.mkNot(transitionSystem.getQuery());
     PTRef inductiveInvariant = kinductiveToInductive(kinductiveInvariant, k, transitionSystem);
@@ -17,11 +17,13 @@ class Kind : public Engine {
 //    Options const & options;
     int verbosity {0};
     bool computeWitness {false};
+    bool parallel {false};
 public:
 
     Kind(Logic & logic, Options const & options) : logic(logic) {
         verbosity = std::stoi(options.getOrDefault(Options::VERBOSE, "0"));
         computeWitness = options.getOrDefault(Options::COMPUTE_WITNESS, "") == "true";
+        parallel = options.getOrDefault(Options::KIND_PARALLEL, "") == "true";
     }
 
     virtual VerificationResult solve(ChcDirectedHyperGraph const & graph) override;
@@ -31,6 +33,8 @@ public:
 private:
     VerificationResult solveTransitionSystem(ChcDirectedGraph const & graph);
     TransitionSystemVerificationResult solveTransitionSystemInternal(TransitionSystem const & system);
+    TransitionSystemVerificationResult solveTransitionSystemInParallel(TransitionSystem const & system,
+                                                                       ArithLogic & arithLogic);
 
     PTRef invariantFromForwardInduction(TransitionSystem const & transitionSystem, unsigned long k) const;
     PTRef invariantFromBackwardInduction(TransitionSystem const & transitionSystem, unsigned long k) const;
@@ -6,10 +6,12 @@
 
 #include "Lawi.h"
 
+#include "Common.h"
 #include "utils/SmtSolver.h"
 
 #include <functional>
 #include <optional>
+#include <unordered_map>
 
 namespace{
 
@@ -45,31 +47,42 @@ public:
     }
 };
 
+/*
+ * Vertices and edges of the tree are stored in vectors indexed by their ids, which are assigned densely.
+ * All children of a vertex are created together when the vertex is expanded, so its outgoing edges form a contiguous
+ * range of edge ids.
+ * Ancestry queries use jump pointers (Myers, 1983): each vertex stores its depth and one extra pointer to an ancestor,
+ * chosen such that any ancestor can be reached in logarithmically many steps.
+ */
 class AbstractReachabilityTree {
 private:
 	struct Edge {
 		VId from;
 		VId to;
+		EId original;
 	};
+    struct Vertex {
+        SymRef location;
+        VId parent;
+        VId jump;
+        std::size_t depth;
+        EId parentEdge;
+        std::size_t firstChildEdge;
+        std::size_t childCount;
+    };
     ChcDirectedGraph const & graph;
     AdjacencyListsGraphRepresentation graphRepresentation;
 
     VId root;
-    std::map<VId, SymRef> toOriginalLoc;
-    std::map<EId, EId> toOriginalEdge;
-    std::size_t vertexCount = 0;
-    VId getNewVertex() { return VId{vertexCount++}; }
-
+    std::vector<Vertex> vertices;
 	std::vector<Edge> edges;
-    std::map<VId, std::vector<EId>> childrenOf;
-    std::map<VId, EId> parentOf;
-
+    // Vertices of each original location, in the order of creation
+    std::unordered_map<SymRef, std::vector<VId>, SymRefHash> verticesOf;
 
 public:
     AbstractReachabilityTree(ChcDirectedGraph const& graph)
         : graph(graph), graphRepresentation(AdjacencyListsGraphRepresentation::from(graph)) {
-        root = getNewVertex();
-        toOriginalLoc.insert({root, graph.getEntry()});
+        root = newVertexFor(graph.getEntry());
     }
 
     bool isErrorLocation(VId vertex) const { return getOriginalLocation(vertex) == getOriginalErrorLocation(); }
@@ -77,7 +90,6 @@ public:
 
     bool isAncestor(VId ancestor, VId descendant) const;
 
-    void fillDescendantsRecusively(VId vertex, std::vector<VId> & descendants) const;
     std::vector<VId> getDescendantsOfIncluding(VId vertex) const;
     std::vector<VId> getAncestorsOfIncluding(VId vertex) const;
     std::vector<VId> getAncestorsOfUntil(VId vertex, VId stop) const;
@@ -87,7 +99,7 @@ public:
 	std::vector<EId> getOutEdgesOf(VId vertex) const;
     std::vector<VId> getEarlierForSameLocationAs(VId vertex) const;
     std::vector<VId> getEarlierForSameLocationAs(VId vertex, size_t limit) const;
-    bool isLeaf(VId vertex) const { return getChildrenOf(vertex).empty(); }
+    bool isLeaf(VId vertex) const { return vertexData(vertex).childCount == 0; }
 
     std::vector<VId> expand(VId vertex);
 
@@ -98,9 +110,10 @@ public:
 	std::vector<VId> getPathVertices(std::vector<EId> const & path) const;
 
     VId getRoot() const { return root; }
+    std::size_t size() const { return vertices.size(); }
 
-    SymRef getOriginalLocation(VId vertex) const { assert(toOriginalLoc.count(vertex) != 0); return toOriginalLoc.at(vertex); }
-	EId getOriginalEdge(EId eid) const { assert(toOriginalEdge.count(eid) != 0); return toOriginalEdge.at(eid); }
+    SymRef getOriginalLocation(VId vertex) const { return vertexData(vertex).location; }
+	EId getOriginalEdge(EId eid) const { assert(eid.id < edges.size()); return edges[eid.id].original; }
 
     void traverse(std::function<void(VId)> fun) const;
 
@@ -112,24 +125,35 @@ public:
 
 private:
     // helpers
+    Vertex const & vertexData(VId vertex) const { assert(vertex.id < vertices.size()); return vertices[vertex.id]; }
+    VId getParent(VId vertex) const { return vertexData(vertex).parent; }
+    VId getJump(VId vertex) const { return vertexData(vertex).jump; }
+    std::size_t getDepth(VId vertex) const { return vertexData(vertex).depth; }
+    VId ancestorAtDepth(VId vertex, std::size_t depth) const;
+
     void connect(VId from, VId to, EId originalEdge) {
         EId eid{edges.size()};
-        edges.push_back(Edge{from, to});
-        toOriginalEdge.insert({eid, originalEdge});
-        auto it = childrenOf.find(from);
-        if (it == childrenOf.end()) {
-            childrenOf.insert({from, std::vector<EId>{eid}});
-        } else {
-            it->second.push_back(eid);
-        }
-        parentOf.insert({to, eid});
+        edges.push_back(Edge{from, to, originalEdge});
+        auto & source = vertices[from.id];
+        assert(source.childCount == 0 || source.firstChildEdge + source.childCount == eid.id);
+        if (source.childCount == 0) { source.firstChildEdge = eid.id; }
+        ++source.childCount;
+        // Jump pointer of the new vertex; it depends only on the jump pointers of its ancestors
+        VId parentJump = source.jump;
+        bool skip = source.depth - getDepth(parentJump) == getDepth(parentJump) - getDepth(getJump(parentJump));
+        auto & target = vertices[to.id];
+        target.parent = from;
+        target.jump = skip ? getJump(parentJump) : from;
+        target.depth = source.depth + 1;
+        target.parentEdge = eid;
     }
 
     SymRef getOriginalErrorLocation() const { return graph.getExit(); };
 
     VId newVertexFor(SymRef originalLocation) {
-        VId nv = getNewVertex();
-        toOriginalLoc.insert({nv, originalLocation});
+        VId nv{vertices.size()};
+        vertices.push_back(Vertex{originalLocation, nv, nv, 0, EId{0}, 0, 0});
+        verticesOf[originalLocation].push_back(nv);
         return nv;
     }
 
@@ -152,9 +176,6 @@ private:
 
     AbstractReachabilityTree const & art;
 
-    std::vector<VId> getDescendantsInclusive(VId vertex) const { return art.getDescendantsOfIncluding(vertex); }
-    std::vector<VId> getAncestorsInclusive(VId vertex) const { return art.getAncestorsOfIncluding(vertex); }
-
 public:
     CoveringRelation(AbstractReachabilityTree const & art) : art(art) {}
 
@@ -168,23 +189,23 @@ private:
 };
 
 class LabelingFunction {
-    std::map<VId, PTRef> labels;
+    // Indexed by vertex id, vertices of the ART are numbered densely
+    std::vector<PTRef> labels;
 public:
     PTRef getLabel(VId vertex) const {
-        assert(labels.count(vertex) != 0);
-        return labels.at(vertex);
+        assert(vertex.id < labels.size() and labels[vertex.id] != PTRef_Undef);
+        return labels[vertex.id];
     }
 
     void addLabel(VId vertex, PTRef label) {
-        assert(labels.count(vertex) == 0);
-        labels.insert({vertex, label});
+        if (vertex.id >= labels.size()) { labels.resize(vertex.id + 1, PTRef_Undef); }
+        assert(labels[vertex.id] == PTRef_Undef);
+        labels[vertex.id] = label;
     }
 
     void replaceLabel(VId vertex, PTRef label) {
-        auto it = labels.find(vertex);
-        assert(it != labels.end());
-        it->second = label;
-
+        assert(vertex.id < labels.size() and labels[vertex.id] != PTRef_Undef);
+        labels[vertex.id] = label;
     }
 };
 
@@ -195,73 +216,78 @@ public:
 
     ImplicationChecker(Logic & logic) : logic(logic) {}
     QueryResult checkImplication(PTRef antecedent, PTRef consequent) {
-        if (antecedent == consequent || antecedent == logic.getTerm_false() || consequent == logic.getTerm_true()) {
-            return QueryResult::VALID;
-        }
-        if (antecedent == logic.getTerm_true() || consequent == logic.getTerm_false()) {
-            return QueryResult::INVALID;
-        }
-        auto pair = std::make_pair(antecedent, consequent);
-        auto it = cache.find(pair);
-        if (it != cache.end()) {
-            return it->second;
-        }
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto known = knownResult(antecedent, consequent);
+        if (known.has_value()) { return known.value(); }
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         PTRef negImpl = logic.mkAnd(antecedent, logic.mkNot(consequent)); // not(A->B) iff A and (not B)
 //        std::cout << logic.printTerm(negImpl) << std::endl;
         solver.insertFormula(negImpl);
-        auto res = solver.check();
-        if (res == s_True) {
-            cache.insert({pair, QueryResult::INVALID});
-            return QueryResult::INVALID;
-        }
-        if (res == s_False) {
-            cache.insert({pair, QueryResult::VALID});
-            return QueryResult::VALID;
-        }
-        if (res == s_Undef) {
-            return QueryResult::UNKNOWN;
-        }
-        if (res == s_Error) {
-            return QueryResult::ERROR;
-        }
-        assert(false);
-        throw std::logic_error("Unreachable code!");
+        return storeResult(antecedent, consequent, solver.check());
     }
 
-    QueryResult checkImplicationWithHints(PTRef antecedent, PTRef consequent, std::vector<std::unique_ptr<Model>>& antecedentModels) {
+    /**
+     * Checks implications from one antecedent to several consequents, e.g., from the label of a vertex to the labels
+     * of all its candidate coverers. The antecedent is asserted only once, into a solver created by the first query
+     * that needs one, and each consequent is checked by assuming its negation. Models of the antecedent found along
+     * the way refute later consequents without calling the solver.
+     */
+    class SameAntecedent {
+    public:
+        SameAntecedent(ImplicationChecker & checker, PTRef antecedent) : checker(checker), antecedent(antecedent) {}
+
+        QueryResult implies(PTRef consequent) {
+            auto known = checker.knownResult(antecedent, consequent);
+            if (known.has_value()) { return known.value(); }
+            Logic & logic = checker.logic;
+            for (auto const & model : models) {
+                assert(model->evaluate(antecedent) == logic.getTerm_true());
+                if (model->evaluate(consequent) == logic.getTerm_false()) {
+                    return checker.storeResult(antecedent, consequent, s_True);
+                }
+            }
+            if (not solver.has_value()) {
+                solver.emplace(SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL));
+                (*solver)->getCoreSolver().insertFormula(antecedent);
+            }
+            auto res = (*solver)->checkUnderAssumptions({logic.mkNot(consequent)});
+            if (res == s_True) { models.push_back((*solver)->getModel()); }
+            return checker.storeResult(antecedent, consequent, res);
+        }
+
+    private:
+        ImplicationChecker & checker;
+        PTRef antecedent;
+        std::optional<SMTSolverPool::Lease> solver;
+        std::vector<std::unique_ptr<Model>> models;
+    };
+
+private:
+    Logic & logic;
+    std::unordered_map<std::pair<PTRef, PTRef>, QueryResult, PTRefPairHash> cache;
+
+    std::optional<QueryResult> knownResult(PTRef antecedent, PTRef consequent) const {
         if (antecedent == consequent || antecedent == logic.getTerm_false() || consequent == logic.getTerm_true()) {
             return QueryResult::VALID;
         }
         if (antecedent == logic.getTerm_true() || consequent == logic.getTerm_false()) {
             return QueryResult::INVALID;
         }
-        auto pair = std::make_pair(antecedent, consequent);
-        auto it = cache.find(pair);
+        auto it = cache.find(std::make_pair(antecedent, consequent));
         if (it != cache.end()) {
             return it->second;
         }
-        for (auto const& model : antecedentModels) {
-            assert(model->evaluate(antecedent) == logic.getTerm_true());
-            if (model->evaluate(consequent) == logic.getTerm_false()) {
-                cache.insert({pair, QueryResult::INVALID});
-                return QueryResult::INVALID;
-            }
-        }
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-        auto & solver = solverWrapper.getCoreSolver();
-        PTRef negImpl = logic.mkAnd(antecedent, logic.mkNot(consequent)); // not(A->B) iff A and (not B)
-//        std::cout << logic.printTerm(negImpl) << std::endl;
-        solver.insertFormula(negImpl);
-        auto res = solver.check();
+        return std::nullopt;
+    }
+
+    // Result of checking the satisfiability of the negated implication
+    QueryResult storeResult(PTRef antecedent, PTRef consequent, sstat res) {
         if (res == s_True) {
-            cache.insert({pair, QueryResult::INVALID});
-            antecedentModels.push_back(solver.getModel());
+            cache.insert({std::make_pair(antecedent, consequent), QueryResult::INVALID});
             return QueryResult::INVALID;
         }
         if (res == s_False) {
-            cache.insert({pair, QueryResult::VALID});
+            cache.insert({std::make_pair(antecedent, consequent), QueryResult::VALID});
             return QueryResult::VALID;
         }
         if (res == s_Undef) {
@@ -273,10 +299,6 @@ public:
         assert(false);
         throw std::logic_error("Unreachable code!");
     }
-
-private:
-    Logic & logic;
-    std::unordered_map<std::pair<PTRef, PTRef>, QueryResult, PTRefPairHash> cache;
 };
 
 class LawiContext{
@@ -296,6 +318,8 @@ class LawiContext{
 
     ErrorPath errorPath;
 
+    CancellationToken cancellationToken;
+
     void removeLeaf(VId leaf) {
         leavesToCheck.erase(std::remove(leavesToCheck.begin(), leavesToCheck.end(), leaf), leavesToCheck.end());
     }
@@ -315,8 +339,8 @@ class LawiContext{
         return implicationChecker.checkImplication(antecedent, consequent);
     }
 
-    ImplicationCheckResult checkImplicationWithHints(PTRef antecedent, PTRef consequent, std::vector<std::unique_ptr<Model>>& antecedentModels) {
-        return implicationChecker.checkImplicationWithHints(antecedent, consequent, antecedentModels);
+    ImplicationCheckResult checkImplicationWithHints(ImplicationChecker::SameAntecedent & antecedent, PTRef consequent) {
+        return antecedent.implies(consequent);
     }
 
     void expand(VId vertex);
@@ -331,7 +355,7 @@ class LawiContext{
     [[maybe_unused]]
     void cover(VId v, VId w);
 
-    bool coverWithHints(VId v, VId w, std::vector<std::unique_ptr<Model>>& vModels);
+    bool coverWithHints(VId v, VId w, ImplicationChecker::SameAntecedent & vLabel);
 
     void close(VId vertex);
 
@@ -357,8 +381,9 @@ class LawiContext{
 
     ErrorPath buildGraphPathFromTreePath(ArtPath const & path) const;
 public:
-    LawiContext(Logic & logic, ChcDirectedGraph const& graph, Options const & options)
-        : logic(logic), graph(graph), options(options), art(graph), coveringRelation(art), implicationChecker(logic) {
+    LawiContext(Logic & logic, ChcDirectedGraph const& graph, Options const & options, CancellationToken cancellationToken)
+        : logic(logic), graph(graph), options(options), art(graph), coveringRelation(art), implicationChecker(logic),
+          cancellationToken(std::move(cancellationToken)) {
         labels.addLabel(art.getRoot(), logic.getTerm_true());
         leavesToCheck.push_back(art.getRoot());
         usingForcedCovering = options.hasOption(Options::FORCED_COVERING);
@@ -377,10 +402,11 @@ public:
 
 void LawiContext::close(VId vertex) {
     auto before = getEarlierForSameLocationAs(vertex);
-    std::vector<std::unique_ptr<Model>> vertexModels;
+    // All candidates are checked against the same label, in one solver
+    ImplicationChecker::SameAntecedent vertexLabel(implicationChecker, labels.getLabel(vertex));
     for (VId earlier : before) {
         if (not coveringRelation.isCovered(earlier)) {
-            bool covered = coverWithHints(vertex, earlier, vertexModels);
+            bool covered = coverWithHints(vertex, earlier, vertexLabel);
             if (covered) { return; }
         }
     }
@@ -402,6 +428,10 @@ VerificationResult LawiContext::unwind() {
                 return VerificationResult(VerificationAnswer::UNSAFE);
             }
         }
+        if (cancellationToken.stopRequested()) {
+            return interruptedResult(cancellationToken,
+                                     "LAWI: Stopped with " + std::to_string(art.size()) + " vertices in the ART");
+        }
         optionalVertex = getUncoveredLeaf();
     }
     if (not computeWitness) { return VerificationResult(VerificationAnswer::SAFE); }
@@ -443,6 +473,7 @@ VerificationResult LawiContext::unwind() {
 
 // Processing of a single leaf
 VerificationAnswer LawiContext::DFS(VId vertex) {
+    if (cancellationToken.stopRequested()) { return VerificationAnswer::UNKNOWN; }
     close(vertex);
     if (coveringRelation.isCovered(vertex)) {
         // this vertex is covered, no need to process
@@ -560,6 +591,8 @@ LawiContext::RefinementResult LawiContext::refine(VId errVertex) {
         // this vertex does not have to be considered anymore
         removeLeaf(errVertex);
         return RefinementResult{VerificationAnswer::UNKNOWN, std::move(strengthened)};
+    } else if (res == s_Undef and cancellationToken.stopRequested()) {
+        return RefinementResult{VerificationAnswer::UNKNOWN, {}};
     } else {
         throw std::logic_error("Error in the SMT solver");
     }
@@ -594,10 +627,10 @@ void LawiContext::cover(VId coveree, VId coverer) {
     }
 }
 
-bool LawiContext::coverWithHints(VId coveree, VId coverer, std::vector<std::unique_ptr<Model>>& covereeModels) {
+bool LawiContext::coverWithHints(VId coveree, VId coverer, ImplicationChecker::SameAntecedent & covereeLabel) {
     if (coveringRelation.isCovered(coveree)) { return true; }
     if (not art.sameLocation(coveree, coverer) || art.isAncestor(coveree, coverer)) { return false; }
-    auto res = checkImplicationWithHints(labels.getLabel(coveree), labels.getLabel(coverer), covereeModels);
+    auto res = checkImplicationWithHints(covereeLabel, labels.getLabel(coverer));
     if (res == decltype(res)::VALID) {
         coveringRelation.updateWith({.coveree = coveree, .coverer = coverer});
         return true;
@@ -608,21 +641,17 @@ bool LawiContext::coverWithHints(VId coveree, VId coverer, std::vector<std::uniq
 void CoveringRelation::updateWith(CoveringRelation::RelElement nElem) {
     assert(std::find(elements.begin(), elements.end(), nElem) == elements.end());
     // descendants of covered vertex cannot cover anything anymore
-    auto descendants = this->getDescendantsInclusive(nElem.coveree);
     elements.erase(std::remove_if(elements.begin(), elements.end(),
-                                  [&descendants](CoveringRelation::RelElement const & elem) {
-        return std::find(descendants.begin(), descendants.end(), elem.coverer) != descendants.end();
+                                  [this, &nElem](CoveringRelation::RelElement const & elem) {
+        return art.isAncestor(nElem.coveree, elem.coverer);
     }), elements.end());
     // add the new element of the relation
     elements.push_back(nElem);
 }
 
 bool CoveringRelation::isCovered(VId vertex) const {
-    auto ancestors = this->getAncestorsInclusive(vertex);
-    return std::any_of(ancestors.begin(), ancestors.end(), [this](VId ancestor) {
-        return std::any_of(elements.begin(), elements.end(), [ancestor](const CoveringRelation::RelElement & elem) {
-           return elem.coveree == ancestor;
-        });
+    return std::any_of(elements.begin(), elements.end(), [this, vertex](const CoveringRelation::RelElement & elem) {
+        return art.isAncestor(elem.coveree, vertex);
     });
 }
 
@@ -650,36 +679,43 @@ std::vector<VId> AbstractReachabilityTree::expand(VId vertex) {
     return children;
 }
 
-bool AbstractReachabilityTree::isAncestor(VId ancestor, VId descendant) const {
-    VId current = descendant;
-    while (current != ancestor && current != root) {
-        assert(parentOf.count(current) != 0);
-        current = getSource(parentOf.at(current));
+VId AbstractReachabilityTree::ancestorAtDepth(VId vertex, std::size_t depth) const {
+    assert(getDepth(vertex) >= depth);
+    while (getDepth(vertex) > depth) {
+        VId jump = getJump(vertex);
+        vertex = getDepth(jump) >= depth ? jump : getParent(vertex);
     }
-    assert(current == ancestor || current == root);
-    return current == ancestor;
+    return vertex;
 }
 
-void AbstractReachabilityTree::fillDescendantsRecusively(VId vertex, std::vector<VId> & descendants) const {
-    descendants.push_back(vertex);
-    auto children = getChildrenOf(vertex);
-    for (VId child : children) {
-        fillDescendantsRecusively(child, descendants);
-    }
+bool AbstractReachabilityTree::isAncestor(VId ancestor, VId descendant) const {
+    if (getDepth(ancestor) > getDepth(descendant)) { return false; }
+    return ancestorAtDepth(descendant, getDepth(ancestor)) == ancestor;
 }
 
 std::vector<VId> AbstractReachabilityTree::getDescendantsOfIncluding(VId vertex) const {
+    // Pre-order, with an explicit stack as the tree can be very deep
     std::vector<VId> res;
-    fillDescendantsRecusively(vertex, res);
+    std::vector<VId> stack{vertex};
+    while (not stack.empty()) {
+        VId current = stack.back();
+        stack.pop_back();
+        res.push_back(current);
+        auto const & data = vertexData(current);
+        for (std::size_t i = data.childCount; i > 0; --i) {
+            stack.push_back(edges[data.firstChildEdge + i - 1].to);
+        }
+    }
     return res;
 }
 
 std::vector<EId> AbstractReachabilityTree::getAncestorPathUntil(VId vertex, VId stop) const {
+	assert(isAncestor(stop, vertex));
 	std::vector<EId> path;
+	path.reserve(getDepth(vertex) - getDepth(stop));
 	VId current = vertex;
 	while (current != stop) {
-		assert(parentOf.count(current) != 0);
-		EId eid = parentOf.at(current);
+		EId eid = vertexData(current).parentEdge;
 		path.push_back(eid);
 		current = getSource(eid);
 	}
@@ -688,9 +724,13 @@ std::vector<EId> AbstractReachabilityTree::getAncestorPathUntil(VId vertex, VId
 }
 
 std::vector<VId> AbstractReachabilityTree::getAncestorsOfUntil(VId vertex, VId stop) const {
+    assert(isAncestor(stop, vertex));
     std::vector<VId> ancestors = {vertex}; // Here we are including 'vertex'
-    auto path = getAncestorPathUntil(vertex, stop);
-    std::transform(path.begin(), path.end(), std::back_inserter(ancestors), [this](EId eid) { return getSource(eid); });
+    ancestors.reserve(getDepth(vertex) - getDepth(stop) + 1);
+    for (VId current = vertex; current != stop;) {
+        current = getParent(current);
+        ancestors.push_back(current);
+    }
     return ancestors;
 }
 
@@ -699,32 +739,46 @@ std::vector<VId> AbstractReachabilityTree::getAncestorsOfIncluding(VId vertex) c
 }
 
 std::vector<VId> AbstractReachabilityTree::getAncestorsOfExcluding(VId vertex) const {
-    auto ancestorsIncluding = getAncestorsOfIncluding(vertex);
-    ancestorsIncluding.erase(ancestorsIncluding.begin());
-    return ancestorsIncluding;
+    std::vector<VId> ancestors;
+    ancestors.reserve(getDepth(vertex));
+    for (VId current = vertex; current != root;) {
+        current = getParent(current);
+        ancestors.push_back(current);
+    }
+    return ancestors;
 }
 
 std::vector<EId> AbstractReachabilityTree::getOutEdgesOf(VId vertex) const {
-	auto it = childrenOf.find(vertex);
-	if (it == childrenOf.end()) { return {}; }
-	return childrenOf.at(vertex);
+	auto const & data = vertexData(vertex);
+	std::vector<EId> outEdges;
+	outEdges.reserve(data.childCount);
+	for (std::size_t i = 0; i < data.childCount; ++i) {
+		outEdges.push_back(EId{data.firstChildEdge + i});
+	}
+	return outEdges;
 }
 
 std::vector<VId> AbstractReachabilityTree::getChildrenOf(VId vertex) const {
-    auto outEdges = getOutEdgesOf(vertex);
+    auto const & data = vertexData(vertex);
     std::vector<VId> children;
-    std::transform(outEdges.begin(), outEdges.end(), std::back_inserter(children), [this](EId outEdge) { return this->edges[outEdge.id].to; });
+    children.reserve(data.childCount);
+    for (std::size_t i = 0; i < data.childCount; ++i) {
+        children.push_back(edges[data.firstChildEdge + i].to);
+    }
     return children;
 }
 
 std::vector<VId> AbstractReachabilityTree::getEarlierForSameLocationAs(VId vertex, size_t limit) const {
     std::vector<VId> res;
-    if (vertex.id == 0) { return res; }
-    for (std::size_t id = vertex.id - 1; id > 0 && res.size() < limit; --id) {
-        VId other{id};
-        if (sameLocation(vertex, other)) {
-            res.push_back(other);
-        }
+    if (vertex == root) { return res; }
+    auto const & sameLocationVertices = verticesOf.at(getOriginalLocation(vertex));
+    // Vertices of a location are sorted by id; skip the vertex itself and everything created after it
+    auto it = std::lower_bound(sameLocationVertices.begin(), sameLocationVertices.end(), vertex,
+                               [](VId v1, VId v2) { return v1.id < v2.id; });
+    for (; it != sameLocationVertices.begin() && res.size() < limit; --it) {
+        VId other = *std::prev(it);
+        if (other == root) { break; }
+        res.push_back(other);
     }
     return res;
 }
@@ -783,18 +837,22 @@ void AbstractReachabilityTree::traverse(std::function<void(VId)> fun) const {
 }
 
 VId AbstractReachabilityTree::nearestCommonAncestor(VId v1, VId v2) const {
-    auto predecessors1 = getAncestorsOfIncluding(v1);
-    VId nca = v2;
-    auto isPredOfV1 = [&predecessors1](VId v) {
-        return std::find(predecessors1.begin(), predecessors1.end(), v) != predecessors1.end();
-    };
-    while (nca != root) {
-        if (isPredOfV1(nca)) { return nca; }
-        nca = getSource(parentOf.at(nca));
+    std::size_t depth = std::min(getDepth(v1), getDepth(v2));
+    v1 = ancestorAtDepth(v1, depth);
+    v2 = ancestorAtDepth(v2, depth);
+    // Vertices at the same depth have jump pointers to the same depth
+    while (v1 != v2) {
+        VId jump1 = getJump(v1);
+        VId jump2 = getJump(v2);
+        if (jump1 != jump2) {
+            v1 = jump1;
+            v2 = jump2;
+        } else {
+            v1 = getParent(v1);
+            v2 = getParent(v2);
+        }
     }
-    assert(nca == root);
-    return nca;
-
+    return v1;
 }
 
 std::optional<VId> LawiContext::getUncoveredLeaf() {
@@ -862,6 +920,6 @@ VerificationResult Lawi::solve(ChcDirectedHyperGraph const & graph) {
 
 
 VerificationResult Lawi::solve(ChcDirectedGraph const & graph) {
-    LawiContext ctx(logic, graph, options);
+    LawiContext ctx(logic, graph, options, cancellationToken);
     return ctx.unwind();
 }
@@ -15,10 +15,12 @@
 #include "TransformationUtils.h"
 #include "transformers/BasicTransformationPipelines.h"
 #include "transformers/SingleLoopTransformation.h"
+#include "utils/SmtSolver.h"
 #include <memory>
 #include <queue>
 #include <set>
 #include <tuple>
+#include <unordered_set>
 
 VerificationResult PDKind::solve(ChcDirectedHyperGraph const & graph) {
     auto pipeline = Transformations::towardsTransitionSystems();
@@ -40,15 +42,26 @@ VerificationResult PDKind::solve(ChcDirectedGraph const & system) {
     if (isTransitionSystem(system)) {
         auto ts = toTransitionSystem(system);
         auto res = solveTransitionSystem(*ts);
+        if (isInterrupted(res)) { return interrupted(res); }
         return translateTransitionSystemResult(res, system, *ts);
     }
     SingleLoopTransformation transformation;
     auto[ts, backtranslator] = transformation.transform(system);
     assert(ts);
     auto res = solveTransitionSystem(*ts);
+    if (isInterrupted(res)) { return interrupted(res); }
     return computeWitness ? backtranslator->translate(res) : VerificationResult(res.answer);
 }
 
+bool PDKind::isInterrupted(TransitionSystemVerificationResult const & result) const {
+    return result.answer == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested();
+}
+
+VerificationResult PDKind::interrupted(TransitionSystemVerificationResult const & result) const {
+    auto n = std::get<std::size_t>(result.witness);
+    return interruptedResult(cancellationToken, "PDKIND: Stopped with induction frame of depth " + std::to_string(n));
+}
+
 /**
  * Solve system with PDKIND algorithm.
  */
@@ -59,9 +72,8 @@ TransitionSystemVerificationResult PDKind::solveTransitionSystem(TransitionSyste
     ReachabilityChecker reachability_checker(logic, system);
 
     { // Check for system with empty initial states and system where initial and bad states intersect.
-        SMTConfig config;
-        TimeMachine tm{logic};
-        MainSolver init_solver(logic, config, "Empty initial states");
+        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
+        auto & init_solver = solverWrapper.getCoreSolver();
         init_solver.insertFormula(init);
         auto res = init_solver.check();
         if (res == s_False) {
@@ -84,6 +96,9 @@ TransitionSystemVerificationResult PDKind::solveTransitionSystem(TransitionSyste
     while (true) {
         int k = n + 1; /* Pick k such that 1 <= k <= n + 1 */
         auto res = push(system, inductionFrame, n, k, reachability_checker);
+        if (cancellationToken.stopRequested()) { // The result of an interrupted push cannot be trusted
+            return TransitionSystemVerificationResult{VerificationAnswer::UNKNOWN, static_cast<std::size_t>(n)};
+        }
 
         if (res.is_invalid) {
             auto steps_to_ctx = res.steps_to_ctx;
@@ -105,9 +120,10 @@ TransitionSystemVerificationResult PDKind::solveTransitionSystem(TransitionSyste
  * Check if p is invariant by iteratively constructing k-inductive strengthening of p.
  */
 PushResult PDKind::push(TransitionSystem const & system, InductionFrame & iframe, int n, int k, ReachabilityChecker & reachability_checker) {
-    // Prepare config and tm for solver initialization.
-    SMTConfig config;
-    TimeMachine tm{logic};
+    // The unrollings of the transition are shared by all rounds; lemmas and counterexamples are versioned by a cache of
+    // this round only, since they change from round to round and would otherwise accumulate without bound
+    auto & transitionUnrollings = system.getUnrollings();
+    UnrollingCache unrollings(logic);
 
     // Create a queue q and initialize it with iframe.
     std::queue<IFrameElement> q;
@@ -122,57 +138,61 @@ PushResult PDKind::push(TransitionSystem const & system, InductionFrame & iframe
     int np = n + k;
     bool invalid = false;
     int steps_to_ctx = 0;
+
+    // Create transition T^k by definition.
+    vec<PTRef> transitions;
+    for (std::size_t currentUnrolling = 0; currentUnrolling < maxUnrollings; ++currentUnrolling) {
+        transitions.push(transitionUnrollings.getVersion(transition, currentUnrolling));
+    }
+    PTRef t_k = logic.mkAnd(transitions);
+
+    // One incremental solver for the whole round holds T[F_ABS]^k, obligations are checked under assumptions.
+    // Lemmas of iframe are only ever strengthened or added during the round, so the lemmas once asserted stay valid.
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    solver.getCoreSolver().insertFormula(t_k);
+    std::unordered_set<PTRef, PTRefHash> assertedLemmas;
+    auto check = [&](PTRef query) {
+        for (auto const & e : iframe) {
+            if (not assertedLemmas.insert(e.lemma).second) { continue; }
+            for (std::size_t currentUnrolling = 0; currentUnrolling < maxUnrollings; ++currentUnrolling) {
+                solver.getCoreSolver().insertFormula(unrollings.getVersion(e.lemma, currentUnrolling));
+            }
+        }
+        vec<PTRef> assumptions;
+        assumptions.push(solver.activationLiteral(query));
+        auto res = solver.checkUnderAssumptions(assumptions);
+        if (res != s_True and res != s_False and not cancellationToken.stopRequested()) {
+            throw std::logic_error("PDKIND: Solver could not decide a query in push");
+        }
+        return res;
+    };
     
     while (not invalid && not q.empty()) {
+        if (cancellationToken.stopRequested()) { break; }
         IFrameElement obligation = q.front();
         q.pop();
-        
-        // Initialize iframe_abs, which is a conjunction of lemmas from iframe.
-        std::vector<PTRef> iframe_abs_vec  = {};
-        for (auto e : iframe) {
-            iframe_abs_vec.push_back(e.lemma);
-        }
-        PTRef iframe_abs = logic.mkAnd(iframe_abs_vec);
-
-        // Create transition T[F_ABS]^k by definition.
-        PTRef t_k = transition;
-        PTRef f_abs_conj = logic.getTerm_true();
-        std::size_t currentUnrolling;
-        for (currentUnrolling = 1; currentUnrolling < maxUnrollings; ++currentUnrolling) {
-            PTRef versionedFla = tm.sendFlaThroughTime(iframe_abs, currentUnrolling);
-            PTRef versionedTransition = tm.sendFlaThroughTime(transition, currentUnrolling);
-            t_k = logic.mkAnd(t_k, versionedTransition);
-            f_abs_conj = logic.mkAnd(f_abs_conj, versionedFla);
-        }
 
         PTRef not_fabs = logic.mkNot(obligation.lemma);
-        PTRef versioned_not_fabs = tm.sendFlaThroughTime(not_fabs, currentUnrolling);
-        PTRef t_k_constr = logic.mkAnd(t_k, f_abs_conj);
+        PTRef versioned_not_fabs = unrollings.getVersion(not_fabs, maxUnrollings);
 
         // Check if iframe_abs is k-inductive?
-        MainSolver solver1(logic, config, "iframe_abs k-inductivity");
-        solver1.insertFormula(iframe_abs);
-        solver1.insertFormula(t_k_constr);
-        solver1.insertFormula(versioned_not_fabs);
-        auto res1 = solver1.check();
+        auto res1 = check(versioned_not_fabs);
+        if (res1 == s_Undef) { break; }
 
         if (res1 == s_False) {
             newIframe.insert(obligation);
             continue;
         }
 
-        auto model1 = solver1.getModel();
+        auto model1 = solver.getModel();
 
         // Check if f_cex is reachable.
-        PTRef f_cex = tm.sendFlaThroughTime(obligation.counter_example.ctx, currentUnrolling);
-        MainSolver solver2(logic, config, "f_cex reachability");
-        solver2.insertFormula(iframe_abs);
-        solver2.insertFormula(t_k_constr);
-        solver2.insertFormula(f_cex);
-        auto res2 = solver2.check();
+        PTRef f_cex = unrollings.getVersion(obligation.counter_example.ctx, maxUnrollings);
+        auto res2 = check(f_cex);
+        if (res2 == s_Undef) { break; }
 
         if (res2 == s_True) {
-            auto model2 = solver2.getModel();
+            auto model2 = solver.getModel();
             CounterExample g_cex(reachability_checker.generalize(*model2, t_k, f_cex), obligation.counter_example.num_of_steps + k);
             // Remember num of steps for each cex, g_cex is f_cex + k
             auto reach_res = reachability_checker.checkReachability(n - k + 1, n, g_cex.ctx);
@@ -228,24 +248,74 @@ PTRef PDKind::getInvariant(const InductionFrame & iframe, unsigned int k, Transi
     return kinductiveToInductive(kinvariant, k, system);
 }
 
+RFrames::Frame & RFrames::getFrame(std::size_t i) {
+    while (r.size() <= i) {
+        r.emplace_back();
+    }
+    return r[i];
+}
+
+PTRef RFrames::operator[](std::size_t i) {
+    return logic.mkAnd(getFrame(i).lemmas);
+}
+
+void RFrames::insert(PTRef fla, std::size_t k) {
+    auto & frame = getFrame(k);
+    for (PTRef lemma : TermUtils(logic).getTopLevelConjuncts(fla)) {
+        if (lemma == logic.getTerm_true() or not frame.known.insert(lemma).second) { continue; }
+        frame.lemmas.push_back(lemma);
+        if (frame.stepSolver) { frame.stepSolver->getCoreSolver().insertFormula(lemma); }
+    }
+}
+
+SMTSolver & RFrames::getStepSolver(std::size_t i) {
+    auto & frame = getFrame(i);
+    if (not frame.stepSolver) {
+        frame.stepSolver = std::make_unique<SMTSolver>(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+        frame.stepSolver->getCoreSolver().insertFormula(transition);
+        for (PTRef lemma : frame.lemmas) {
+            frame.stepSolver->getCoreSolver().insertFormula(lemma);
+        }
+    }
+    return *frame.stepSolver;
+}
+
 /**
  * Recursively checks if formula is reachable in k steps from initial states by updating and using the reachability frame.
+ * Both answers stay valid as the frames are refined, so they are computed only once for each k and formula.
  * @param k number of steps
  * @return true if is reachable, false and interpolant if isn't
  */
 std::tuple<bool, PTRef> ReachabilityChecker::reachable(unsigned k, PTRef formula) {
-    SMTConfig config;
-    const char * msg = "ok";
-    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
-    config.setSimplifyInterpolant(4);
+    auto key = std::make_pair(k, formula);
+    if (auto it = results.find(key); it != results.end()) { return it->second; }
+    auto result = decideReachable(k, formula);
+    if (CancellationToken::current().stopRequested()) { return result; }
+    // Unreachable answers have strengthened the frames, so forgetting the answers makes repeated checks cheap
+    if (results.size() >= maxResults) { results.clear(); }
+    results.emplace(key, result);
+    return result;
+}
+
+std::tuple<bool, PTRef> ReachabilityChecker::decideReachable(unsigned k, PTRef formula) {
+    // Interpolating solvers go through SMTSolver, so that the cancellation token of the engine can stop them
+    auto mkInterpolatingSolver = [&]() {
+        auto solverWrapper = std::make_unique<SMTSolver>(logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS);
+        solverWrapper->getConfig().setSimplifyInterpolant(4);
+        return solverWrapper;
+    };
     TimeMachine tm{logic};
 
     // Check reachability from initial states in 0 steps.
     if (k == 0) {
-        MainSolver init_solver(logic, config, "Init state reachability");
+        auto solverWrapper = mkInterpolatingSolver();
+        auto & init_solver = solverWrapper->getCoreSolver();
         init_solver.insertFormula(system.getInit());
         init_solver.insertFormula(formula);
         auto res = init_solver.check();
+        if (res == s_Undef and CancellationToken::current().stopRequested()) {
+            return std::make_tuple(false, logic.getTerm_true());
+        }
         if (res == s_False) {
             auto itpContext = init_solver.getInterpolationContext();
             vec<PTRef> itps;
@@ -259,15 +329,17 @@ std::tuple<bool, PTRef> ReachabilityChecker::reachable(unsigned k, PTRef formula
     PTRef versioned_formula = tm.sendFlaThroughTime(formula, 1); // Send the formula through time by one, so it matches the pattern init_0 transition_0-1 formula_1.
     while (true) {
         // Check if formula is reachable from r_frames[k-1] in 1 step.
-        MainSolver solver(logic, config, "Transitioned states rechability");
-        solver.insertFormula(r_frames[k-1]);
-        solver.insertFormula(system.getTransition());
-        solver.insertFormula(versioned_formula);
-        auto res = solver.check();
+        // The formula is only checked once per refinement of the frame, so it is not worth an activation literal
+        auto & stepSolver = r_frames.getStepSolver(k-1);
+        auto res = stepSolver.checkUnderAssumptions({}, versioned_formula);
+        if (res == s_Undef) {
+            if (CancellationToken::current().stopRequested()) { return std::make_tuple(false, logic.getTerm_true()); }
+            throw std::logic_error("PDKIND: Solver could not decide reachability from a frame");
+        }
 
         // If is reachable, create a generalization of such states and check if they are reachable in k-1 steps.
         if (res == s_True) {
-            auto model = solver.getModel();
+            auto model = stepSolver.getModel();
             PTRef g = generalize(*model,system.getTransition(), versioned_formula);
             auto reach_res = reachable(k-1, g);
             // If is reachable return true, else update the reachability frame.
@@ -277,6 +349,17 @@ std::tuple<bool, PTRef> ReachabilityChecker::reachable(unsigned k, PTRef formula
                 r_frames.insert(std::get<1>(reach_res), k-1);
             }
         } else {
+            // Only the final, unsatisfiable query needs an interpolating solver.
+            auto solverWrapper = mkInterpolatingSolver();
+            auto & solver = solverWrapper->getCoreSolver();
+            solver.insertFormula(r_frames[k-1]);
+            solver.insertFormula(system.getTransition());
+            solver.insertFormula(versioned_formula);
+            auto itpRes = solver.check();
+            if (itpRes == s_Undef and CancellationToken::current().stopRequested()) {
+                return std::make_tuple(false, logic.getTerm_true());
+            }
+            assert(itpRes == s_False);
             auto itpContext = solver.getInterpolationContext();
             vec<PTRef> itps;
             int mask = 3;
@@ -285,20 +368,9 @@ std::tuple<bool, PTRef> ReachabilityChecker::reachable(unsigned k, PTRef formula
             PTRef interpolant = tm.sendFlaThroughTime(itps[0], -1);
 
             // Get interpolant for initial states. If it exists, return disjunction of both interpolants.
-            MainSolver init_solver(logic, config, "Initial states interpolant");
-            init_solver.insertFormula(system.getInit());
-            init_solver.insertFormula(formula);
-
-            auto res = init_solver.check();
-            if (res == s_False) {
-                auto itpContext = init_solver.getInterpolationContext();
-                vec<PTRef> itps;
-                int mask = 1;
-                itpContext->getSingleInterpolant(itps, mask);
-                assert(itps.size() == 1);
-                PTRef init_interpolant = itps[0];
-
-                return std::make_tuple(false, logic.mkOr(interpolant, init_interpolant));
+            auto init_res = reachable(0, formula);
+            if (not std::get<0>(init_res)) {
+                return std::make_tuple(false, logic.mkOr(interpolant, std::get<1>(init_res)));
             }
 
             return std::make_tuple(false, interpolant);
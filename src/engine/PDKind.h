@@ -11,9 +11,12 @@
 #include "MainSolver.h"
 #include "PTRef.h"
 #include "TransitionSystem.h"
+#include "utils/SmtSolver.h"
+#include <map>
 #include <memory>
 #include <set>
 #include <tuple>
+#include <unordered_set>
 
 /**
  * Counter example formula in addition with number of steps needed to reach the counter example.
@@ -79,44 +82,50 @@ struct PushResult {
 
 /**
  * A data structure where r[i] represents the states that are reachable in i steps from some initial states, i.e., r[0].
+ *
+ * Each frame is kept as a set of lemmas, the top-level conjuncts of the inserted formulas; lemmas already in the frame
+ * are not added again. Each frame also has an incremental solver with the transition relation and the lemmas of the
+ * frame asserted, which answers the queries about the states reachable from the frame in one step.
  */
 class RFrames {
-    std::vector<PTRef> r;
+    struct Frame {
+        std::vector<PTRef> lemmas;
+        std::unordered_set<PTRef, PTRefHash> known;
+        std::unique_ptr<SMTSolver> stepSolver;
+    };
+    std::vector<Frame> r;
     Logic & logic;
+    PTRef transition;
+
+    Frame & getFrame(std::size_t i);
 public:
-    RFrames(Logic & logic) : logic(logic) {}
+    RFrames(Logic & logic, PTRef transition) : logic(logic), transition(transition) {}
 
-    const PTRef & operator[] (size_t i) {
-        if (i >= r.size()) {
-            while (r.size() <= i) {
-                r.push_back(logic.getTerm_true());
-            }
-        }
-        return r[i];
-    }
+    PTRef operator[] (std::size_t i);
 
-    void insert(PTRef fla, size_t k) {
-        if (k >= r.size()) {
-            while (r.size() <= k) {
-                r.push_back(logic.getTerm_true());
-            }
-        }
-        PTRef new_fla = logic.mkAnd(r[k], fla);
-        r[k] = new_fla;
-    }
+    void insert(PTRef fla, std::size_t k);
+
+    SMTSolver & getStepSolver(std::size_t i);
 };
 
 /**
  * Each instance builds its own reachability frame and uses it to check if other states are reachable in k steps.
+ * The answers are remembered, as the same formulas are checked repeatedly for overlapping ranges of steps. Most of the
+ * checked formulas are generalizations that never come back, so the answers are forgotten once there are too many.
  */
 class ReachabilityChecker {
 private:
+    static constexpr std::size_t maxResults = 10000;
+
     RFrames r_frames;
     Logic & logic;
     TransitionSystem const & system;
+    std::map<std::pair<unsigned, PTRef>, std::tuple<bool, PTRef>> results;
     std::tuple<bool, PTRef> reachable(unsigned k, PTRef formula);
+    std::tuple<bool, PTRef> decideReachable(unsigned k, PTRef formula);
 public:
-    ReachabilityChecker(Logic & logic, TransitionSystem const & system) : r_frames(logic), logic(logic), system(system) {}
+    ReachabilityChecker(Logic & logic, TransitionSystem const & system)
+        : r_frames(logic, system.getTransition()), logic(logic), system(system) {}
     std::tuple<bool, int, PTRef> checkReachability(int from, int to, PTRef formula);
     PTRef generalize(Model & model, PTRef transition, PTRef formula);
 };
@@ -145,6 +154,9 @@ class PDKind : public Engine {
         PushResult push(TransitionSystem const & system, InductionFrame & iframe, int n, int k, ReachabilityChecker & reachability_checker);
         TransitionSystemVerificationResult solveTransitionSystem(TransitionSystem const & system);
         PTRef getInvariant(InductionFrame const & iframe, unsigned int k, TransitionSystem const & system);
+
+        bool isInterrupted(TransitionSystemVerificationResult const & result) const;
+        VerificationResult interrupted(TransitionSystemVerificationResult const & result) const;
 };
 
 #endif // GOLEM_PDKIND_H
\ No newline at end of file
@@ -6,10 +6,18 @@
 
 #include "Spacer.h"
 
+#include "Common.h"
+
 #include "utils/SmtSolver.h"
+#include "utils/TermTranslator.h"
 #include "ModelBasedProjection.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
 #include <queue>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -40,6 +48,15 @@ public:
         components.insert(summary);
     }
 
+    void remove(SymRef vid, std::size_t bound, PTRef summary) {
+        ensureBound(bound);
+        auto & boundMap = innerMap[bound];
+        auto it = boundMap.find(vid);
+        if (it != boundMap.end()) {
+            it->second.erase(summary);
+        }
+    }
+
     bool has(SymRef vid, std::size_t bound, PTRef summary) {
         ensureBound(bound);
         auto const & boundMap = innerMap[bound];
@@ -106,19 +123,36 @@ public:
 
     [[nodiscard]] ID getIdFor(DerivedFact fact) const;
 
+    // View of the premises of a derivation; valid until the next derivation is added
+    class Premises {
+        ID const * first;
+        std::size_t count;
+
+    public:
+        Premises(ID const * first, std::size_t count) : first(first), count(count) {}
+        ID operator[](std::size_t i) const { assert(i < count); return first[i]; }
+        [[nodiscard]] std::size_t size() const { return count; }
+        [[nodiscard]] bool empty() const { return count == 0; }
+        ID const * begin() const { return first; }
+        ID const * end() const { return first + count; }
+    };
+
     struct Entry {
         DerivedFact derivedFact;
         EId incomingEdge;
-        std::vector<ID> premises;
+        Premises premises;
     };
 
-    void newDerivation(DerivedFact fact, EId edge, std::vector<ID> premises);
+    void newDerivation(DerivedFact fact, EId edge, std::vector<ID> const & premises);
+
+    [[nodiscard]] Entry getEntry(ID index) const;
 
-    Entry const & getEntry(ID index) const { assert(index < table.size()); return table.at(index); }
+    [[nodiscard]] std::size_t size() const { return table.size(); }
 
     // DEBUG
     void print(Logic & logic) const {
-        for (auto const & entry : *this) {
+        for (ID id = 0; id < size(); ++id) {
+            auto entry = getEntry(id);
             std::cout << logic.printSym(entry.derivedFact.node) << " " << logic.pp(entry.derivedFact.fact) << " " << entry.incomingEdge.id << " | ";
             for (auto premise : entry.premises) {
                 std::cout << premise << " ";
@@ -128,14 +162,22 @@ public:
     }
 
 private:
-    std::vector<Entry> table;
-
-public:
-    using const_iterator = decltype(table)::const_iterator;
+    struct Record {
+        DerivedFact derivedFact;
+        EId incomingEdge;
+        std::size_t premisesBegin;
+        std::size_t premisesEnd;
+    };
 
-    const_iterator begin() const { return table.begin(); }
-    const_iterator end() const { return table.end(); }
+    struct DerivedFactHash {
+        std::size_t operator()(DerivedFact const & fact) const {
+            return PTRefHash{}(fact.fact) ^ (SymRefHash{}(fact.node) << 1);
+        }
+    };
 
+    std::vector<Record> table;
+    std::vector<ID> premiseArena; // Premises of all derivations, stored contiguously
+    std::unordered_map<DerivedFact, ID, DerivedFactHash> index;
 };
 
 bool operator==(DerivationDatabase::DerivedFact const & first, DerivationDatabase::DerivedFact const & second) {
@@ -143,16 +185,24 @@ bool operator==(DerivationDatabase::DerivedFact const & first, DerivationDatabas
 }
 
 DerivationDatabase::ID DerivationDatabase::getIdFor(DerivationDatabase::DerivedFact fact) const {
-    for (std::size_t i = 0u; i < table.size(); ++i) {
-        if (table[i].derivedFact == fact) {
-            return i;
-        }
-    }
+    auto it = index.find(fact);
+    if (it != index.end()) { return it->second; }
     throw std::logic_error("Given fact not found in the database of derived facts");
 }
 
-void DerivationDatabase::newDerivation(DerivationDatabase::DerivedFact fact, EId edge, std::vector<ID> premises) {
-    table.push_back({.derivedFact = fact, .incomingEdge = edge, .premises = std::move(premises)});
+void DerivationDatabase::newDerivation(DerivationDatabase::DerivedFact fact, EId edge, std::vector<ID> const & premises) {
+    std::size_t premisesBegin = premiseArena.size();
+    premiseArena.insert(premiseArena.end(), premises.begin(), premises.end());
+    index.insert({fact, table.size()}); // The first derivation of a fact is its canonical one
+    table.push_back({.derivedFact = fact, .incomingEdge = edge, .premisesBegin = premisesBegin, .premisesEnd = premiseArena.size()});
+}
+
+DerivationDatabase::Entry DerivationDatabase::getEntry(ID id) const {
+    assert(id < table.size());
+    auto const & record = table.at(id);
+    return {.derivedFact = record.derivedFact,
+            .incomingEdge = record.incomingEdge,
+            .premises = Premises(premiseArena.data() + record.premisesBegin, record.premisesEnd - record.premisesBegin)};
 }
 
 class SpacerContext {
@@ -164,11 +214,37 @@ class SpacerContext {
 
     DerivationDatabase database;
     bool logProof;
+    CancellationToken cancellationToken;
+
+    // Proven invariants exchanged with other engines; they are part of the may summaries at all levels
+    std::optional<LemmaBus::Subscription> lemmaSubscription;
+    std::unordered_map<SymRef, std::unordered_set<PTRef, PTRefHash>, SymRefHash> sharedFacts;
 
     std::size_t lowestChangedLevel = 0;
 
     // Helper data structures to get the versioning right
     ChcDirectedHyperGraph::VertexInstances vertexInstances;
+    VersionManager versionManager;
+
+    // Incoming edges are needed for every proof obligation and every vertex in the inductive check; compute them once
+    AdjacencyListsGraphRepresentation adjacency;
+
+    // Incremental solvers with the constraint of an edge asserted once; summaries are passed as assumptions
+    std::unordered_map<std::size_t, std::unique_ptr<SMTSolver>> edgeSolvers;
+    // Summary components that have been subsumed or dropped keep their activation clauses in the edge solvers,
+    // so a solver is rebuilt once it has guarded this many components
+    static constexpr std::size_t maxEdgeActivations = 1000;
+
+    // Workers pushing lemmas of different vertices in parallel; the term store is not thread-safe, so each has its own
+    struct PushWorker {
+        ArithLogic logic;
+        TermTranslator translator;
+
+        explicit PushWorker(ArithLogic & source)
+            : logic(source.hasIntegers() ? opensmt::Logic_t::QF_LIA : opensmt::Logic_t::QF_LRA),
+              translator(source, logic) {}
+    };
+    std::vector<std::unique_ptr<PushWorker>> pushWorkers;
 
     void addMaySummary(SymRef vid, std::size_t bound, PTRef summary) {
         over.insert(vid, bound, summary);
@@ -178,6 +254,8 @@ class SpacerContext {
         under.insert(vid, bound, summary);
     }
 
+    void addLemma(SymRef vid, std::size_t bound, PTRef lemma);
+
     PTRef getMustSummary(SymRef vid, std::size_t bound) const {
         return logic.mkOr(under.getComponents(vid, bound));
     }
@@ -192,7 +270,15 @@ class SpacerContext {
 
     PTRef getEdgeMixedSummary(EId eid, std::size_t bound, std::size_t lastMayIndex) const;
 
-    enum class BoundedSafetyResult { SAFE, UNSAFE };
+    vec<PTRef> getEdgeMustComponents(EId eid, std::size_t bound) const;
+
+    vec<PTRef> getEdgeMayComponents(EId eid, std::size_t bound) const;
+
+    vec<PTRef> getEdgeMixedComponents(EId eid, std::size_t bound, std::size_t lastMayIndex) const;
+
+    vec<PTRef> getEdgeSourceComponents(EId eid, std::size_t bound, std::size_t mayCount) const;
+
+    enum class BoundedSafetyResult { SAFE, UNSAFE, UNKNOWN };
 
     BoundedSafetyResult boundSafety(std::size_t currentBound);
 
@@ -207,13 +293,21 @@ class SpacerContext {
 
     bool tryPushComponents(SymRef, std::size_t, PTRef);
 
+    std::optional<bool> tryPushComponentsInParallel(std::size_t level);
+
+    PTRef getBodyMaySummary(SymRef vid, std::size_t level) const;
+
+    std::vector<PTRef> pushCandidates(SymRef vid, std::size_t level);
+
+    bool addPushedComponents(SymRef vid, std::size_t level, std::vector<PTRef> const & candidates,
+                             std::vector<bool> const & implied);
+
 
     enum class QueryAnswer : char {UNKNOWN, SAT, UNSAT, ERROR};
     struct QueryResult {
         QueryAnswer answer;
         std::unique_ptr<Model> model;
     };
-    QueryResult sat(PTRef A, PTRef B) const;
 
     struct ItpQueryResult {
         QueryAnswer answer;
@@ -221,30 +315,52 @@ class SpacerContext {
     };
     ItpQueryResult interpolatingSat(PTRef A, PTRef B);
 
+    QueryResult edgeSat(EId eid, vec<PTRef> const & summaryComponents, PTRef constraint);
+
     bool checkMustReachability(std::vector<EId> const & edges, ProofObligation const & pob);
 
-    bool mayReachable(EId eid, PTRef targetConstraint, std::size_t bound) const;
+    bool mayReachable(EId eid, PTRef targetConstraint, std::size_t bound);
 
-    std::optional<ProofObligation> computePredecessor(EId eid, ProofObligation const & pob) const;
+    std::optional<ProofObligation> computePredecessor(EId eid, ProofObligation const & pob);
 
     PTRef projectFormula(PTRef fla, vec<PTRef> const & vars, Model & model) const;
 
     void logNewFactIntoDatabase(PTRef fact, SymRef vertex, std::size_t sourceLevel, EId eid, Model & model);
 
     InvalidityWitness reconstructInvalidityWitness() const;
+
+    VerificationResult interrupted(std::size_t currentBound) const;
+
+    PTRef basePredicateInstance(SymRef vid) const;
+
+    void importSharedFacts(std::size_t currentBound);
+
+    void publishInvariants(std::size_t level);
+
+    bool keepInductiveSubset(std::unordered_map<SymRef, std::vector<PTRef>, SymRefHash> & candidates) const;
 public:
-    SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof);
+    SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof,
+                  CancellationToken cancellationToken, LemmaBus * lemmaBus, std::size_t pushThreads);
 
     VerificationResult run();
 };
 
 VerificationResult Spacer::solve(ChcDirectedHyperGraph const & system) {
     bool logProof = options.hasOption(Options::COMPUTE_WITNESS) and options.getOption(Options::COMPUTE_WITNESS) == "true";
-    return SpacerContext(logic, system, logProof).run();
+    auto pushThreads = std::stoul(options.getOrDefault(Options::SPACER_PUSH_THREADS, "1"));
+    return SpacerContext(logic, system, logProof, cancellationToken, lemmaBus, pushThreads).run();
 }
 
-SpacerContext::SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof)
-    : logic(logic), graph(graph), logProof(logProof), vertexInstances(graph) {
+SpacerContext::SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph, bool logProof,
+                             CancellationToken cancellationToken, LemmaBus * lemmaBus, std::size_t pushThreads)
+    : logic(logic), graph(graph), logProof(logProof), cancellationToken(std::move(cancellationToken)),
+      vertexInstances(graph), versionManager(logic), adjacency(AdjacencyListsGraphRepresentation::from(graph)) {
+    if (lemmaBus) { lemmaSubscription.emplace(*lemmaBus, logic); }
+    if (auto * arithLogic = dynamic_cast<ArithLogic *>(&logic); arithLogic and pushThreads > 1) {
+        for (std::size_t i = 0; i < pushThreads; ++i) {
+            pushWorkers.push_back(std::make_unique<PushWorker>(*arithLogic));
+        }
+    }
     auto vertices = graph.getVertices();
     for (auto vid : vertices) {
         PTRef toInsert = vid == graph.getEntry() ? logic.getTerm_true() : logic.getTerm_false();
@@ -257,8 +373,10 @@ SpacerContext::SpacerContext(Logic & logic, ChcDirectedHyperGraph const & graph,
 VerificationResult SpacerContext::run() {
     std::size_t currentBound = 1;
     while(true) {
+        if (cancellationToken.stopRequested()) { return interrupted(currentBound); }
         addMaySummary(graph.getEntry(), currentBound, logic.getTerm_true());
         addMustSummary(graph.getEntry(), currentBound, logic.getTerm_true());
+        if (lemmaSubscription) { importSharedFacts(currentBound); }
         TRACE(1, "Checking bound safety for " << currentBound)
         auto boundedResult = boundSafety(currentBound);
         switch (boundedResult) {
@@ -273,7 +391,7 @@ VerificationResult SpacerContext::run() {
                         PTRef statePredicate = graph.getStateVersion(vid);
                         if (vid == graph.getEntry() or vid == graph.getExit()) { continue; }
                         // MB: 0-ary predicate would be treated as variables in VersionManager, not what we want
-                        PTRef predicate = logic.getPterm(statePredicate).size() > 0 ? VersionManager(logic).sourceFormulaToBase(statePredicate) : statePredicate;
+                        PTRef predicate = logic.getPterm(statePredicate).size() > 0 ? versionManager.sourceFormulaToBase(statePredicate) : statePredicate;
                         PTRef invariantSummary = logic.mkAnd(over.getComponents(vid, inductiveLevel));
                         if (logic.isOr(invariantSummary) or logic.isAnd(invariantSummary)) {
                             invariantSummary = simplifyUnderAssignment_Aggressive(invariantSummary, logic);
@@ -286,9 +404,12 @@ VerificationResult SpacerContext::run() {
                     }
                     return {VerificationAnswer::SAFE, ValidityWitness(std::move(solution))};
                 }
+                if (lemmaSubscription) { publishInvariants(currentBound); }
                 ++currentBound;
                 break;
             }
+            case BoundedSafetyResult::UNKNOWN:
+                return interrupted(currentBound);
             default:
                 assert(false);
                 throw std::logic_error("Unreachable!");
@@ -296,16 +417,116 @@ VerificationResult SpacerContext::run() {
     }
 }
 
+VerificationResult SpacerContext::interrupted(std::size_t currentBound) const {
+    return interruptedResult(cancellationToken, "SPACER: Safe up to bound " + std::to_string(currentBound - 1));
+}
 
-std::vector<EId> incomingEdges(SymRef v, ChcDirectedHyperGraph const & graph) {
-    // TODO: Remember the adjacency representation and do not recompute this all the time
-    std::vector<EId> incoming;
-    graph.forEachEdge([&](auto const & edge) {
-       if (graph.getTarget(edge.id) == v) { incoming.push_back(edge.id); }
-    });
-    return incoming;
+PTRef SpacerContext::basePredicateInstance(SymRef vid) const {
+    PTRef statePredicate = graph.getStateVersion(vid);
+    // MB: 0-ary predicate would be treated as variables in VersionManager; there are no facts to share about them
+    if (logic.getPterm(statePredicate).size() == 0) { return PTRef_Undef; }
+    return versionManager.sourceFormulaToBase(statePredicate);
+}
+
+/*
+ * Adds the invariants received from other engines, and all the invariants known so far, to the may summaries up to the
+ * current bound. Invariants over-approximate the reachable states, so they are valid at all levels.
+ */
+void SpacerContext::importSharedFacts(std::size_t currentBound) {
+    vec<PTRef> instances;
+    std::unordered_map<PTRef, SymRef, PTRefHash> vertexOf;
+    for (auto vid : graph.getVertices()) {
+        if (vid == graph.getEntry() or vid == graph.getExit()) { continue; }
+        PTRef instance = basePredicateInstance(vid);
+        if (instance == PTRef_Undef) { continue; }
+        instances.push(instance);
+        vertexOf.insert({instance, vid});
+    }
+    for (auto const & received : lemmaSubscription->receive(instances)) {
+        SymRef vid = vertexOf.at(received.predicateInstance);
+        if (not sharedFacts[vid].insert(received.fact).second) { continue; }
+        TRACE(1, "Received invariant for " << vid.x << " - " << logic.pp(received.fact))
+        for (std::size_t level = 1; level < currentBound; ++level) {
+            addMaySummary(vid, level, received.fact);
+        }
+    }
+    for (auto const & [vid, facts] : sharedFacts) {
+        for (PTRef fact : facts) {
+            addMaySummary(vid, currentBound, fact);
+        }
+    }
+}
+
+/*
+ * Publishes the largest subset of the lemmas at the given level that is inductive on its own.
+ * Such lemmas are invariants of the system, valid regardless of the bound.
+ */
+void SpacerContext::publishInvariants(std::size_t level) {
+    std::unordered_map<SymRef, std::vector<PTRef>, SymRefHash> candidates;
+    for (auto vid : graph.getVertices()) {
+        if (vid == graph.getEntry() or vid == graph.getExit()) { continue; }
+        auto components = over.getComponents(vid, level);
+        candidates.insert({vid, std::vector<PTRef>(components.begin(), components.end())});
+    }
+    if (not keepInductiveSubset(candidates)) { return; }
+    for (auto const & [vid, invariants] : candidates) {
+        PTRef instance = basePredicateInstance(vid);
+        if (instance == PTRef_Undef) { continue; }
+        for (PTRef invariant : invariants) {
+            if (not sharedFacts[vid].insert(invariant).second) { continue; }
+            TRACE(1, "Publishing invariant for " << vid.x << " - " << logic.pp(invariant))
+            lemmaSubscription->publish(instance, invariant);
+        }
+    }
 }
 
+/*
+ * Houdini-style filtering: drops candidates not implied by the candidates of the sources over some incoming edge,
+ * until the remaining candidates are inductive. Returns false if the check has been interrupted.
+ */
+bool SpacerContext::keepInductiveSubset(std::unordered_map<SymRef, std::vector<PTRef>, SymRefHash> & candidates) const {
+    auto sourceCandidates = [&](SymRef vid) {
+        auto it = candidates.find(vid);
+        return it == candidates.end() ? logic.getTerm_true() : logic.mkAnd(it->second);
+    };
+    auto edges = graph.getEdges();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto const & edge : edges) {
+            auto it = candidates.find(edge.to);
+            if (it == candidates.end() or it->second.empty()) { continue; }
+            vec<PTRef> bodyComponents{edge.fla.fla};
+            for (unsigned sourceIndex = 0; sourceIndex < edge.from.size(); ++sourceIndex) {
+                PTRef summary = sourceCandidates(edge.from[sourceIndex]);
+                bodyComponents.push(versionManager.baseFormulaToSource(summary, vertexInstances.getInstanceNumber(edge.id, sourceIndex)));
+            }
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
+            solver.insertFormula(logic.mkAnd(std::move(bodyComponents)));
+            auto & targetCandidates = it->second;
+            std::vector<PTRef> kept;
+            for (PTRef candidate : targetCandidates) {
+                solver.push();
+                solver.insertFormula(logic.mkNot(versionManager.baseFormulaToTarget(candidate)));
+                auto res = solver.check();
+                solver.pop();
+                if (res == s_False) {
+                    kept.push_back(candidate);
+                } else if (res != s_True) {
+                    return false;
+                }
+            }
+            if (kept.size() != targetCandidates.size()) {
+                targetCandidates = std::move(kept);
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+
 SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t currentBound) {
     TRACE(1, "\nRunning bounded safety check at level " << currentBound)
     auto query = graph.getExit();
@@ -313,13 +534,14 @@ SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t curren
     pqueue.push(ProofObligation{query, currentBound, logic.getTerm_true()});
     lowestChangedLevel = currentBound;
     while(not pqueue.empty()) {
+        if (cancellationToken.stopRequested()) { return BoundedSafetyResult::UNKNOWN; }
         TRACE(2, "Examining proof obligation " << pqueue.peek().vertex.x)
         auto const & pob = pqueue.peek();
         if (pob.vertex == graph.getEntry()) {
             assert(false); // With the must summaries, we actually never finish here
             return BoundedSafetyResult::UNSAFE;
         }
-        auto edges = incomingEdges(pob.vertex, graph);
+        auto const & edges = adjacency.getIncomingEdgesFor(pob.vertex);
         bool mustReached = checkMustReachability(edges, pob);
         if (mustReached) {
             if (pob.vertex == query) {
@@ -335,6 +557,8 @@ SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t curren
                 newProofObligations.push_back(newProofObligation.value());
             }
         }
+        // Interrupted queries do not produce proof obligations, the edges are not really blocked
+        if (cancellationToken.stopRequested()) { return BoundedSafetyResult::UNKNOWN; }
         if (newProofObligations.empty()) {
             // all edges are blocked; compute new lemma blocking the current proof obligation
             // TODO:
@@ -342,14 +566,18 @@ SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t curren
             for (EId eid : edges) {
                 edgeRepresentations.push(getEdgeMaySummary(eid, pob.bound - 1));
             }
-            auto res = interpolatingSat(logic.mkOr(edgeRepresentations), pob.constraint);
+            PTRef body = logic.mkOr(edgeRepresentations);
+            auto res = interpolatingSat(body, pob.constraint);
             assert(res.answer == QueryAnswer::UNSAT);
             if (res.answer != QueryAnswer::UNSAT) {
                 throw std::logic_error("All edges should have been blocked, but they are not!");
             }
-            PTRef newLemma = VersionManager(logic).targetFormulaToBase(res.interpolant);
-            TRACE(2, "Learnt new lemma for " << pob.vertex.x << " at level " << pob.bound << " - " << logic.pp(newLemma))
-            addMaySummary(pob.vertex, pob.bound, newLemma);
+            // The interpolant is in the target version, as are the body and the constraint
+            for (PTRef lemma : SpacerLemmas(logic).generalize(res.interpolant, body, pob.constraint)) {
+                PTRef newLemma = versionManager.targetFormulaToBase(lemma);
+                TRACE(2, "Learnt new lemma for " << pob.vertex.x << " at level " << pob.bound << " - " << logic.pp(newLemma))
+                addLemma(pob.vertex, pob.bound, newLemma);
+            }
             if (pob.bound < lowestChangedLevel) {
                 lowestChangedLevel = pob.bound;
             }
@@ -364,23 +592,24 @@ SpacerContext::BoundedSafetyResult SpacerContext::boundSafety(std::size_t curren
     return BoundedSafetyResult::SAFE; // not reachable at this bound
 }
 
-SpacerContext::QueryResult SpacerContext::sat(PTRef A, PTRef B) const {
-    QueryResult qres;
-    if (A == logic.getTerm_false()) {
-        qres.answer = QueryAnswer::UNSAT;
-        return qres;
-    }
-    SMTSolver solverWrapper(logic);
+SpacerContext::ItpQueryResult SpacerContext::interpolatingSat(PTRef A, PTRef B) {
+    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS);
+    solverWrapper.getConfig().setSimplifyInterpolant(4);
     auto & solver = solverWrapper.getCoreSolver();
     solver.insertFormula(A);
     solver.insertFormula(B);
     auto res = solver.check();
+    ItpQueryResult qres;
     if (res == s_True) {
         qres.answer = QueryAnswer::SAT;
-        qres.model = solver.getModel();
     }
     else if (res == s_False) {
         qres.answer = QueryAnswer::UNSAT;
+        auto itpCtx = solver.getInterpolationContext();
+        std::vector<PTRef> itps;
+        ipartitions_t mask = 1;
+        itpCtx->getSingleInterpolant(itps, mask);
+        qres.interpolant = itps[0];
     }
     else if (res == s_Undef) {
         qres.answer = QueryAnswer::UNKNOWN;
@@ -395,24 +624,114 @@ SpacerContext::QueryResult SpacerContext::sat(PTRef A, PTRef B) const {
     return qres;
 }
 
-SpacerContext::ItpQueryResult SpacerContext::interpolatingSat(PTRef A, PTRef B) {
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS);
-    solverWrapper.getConfig().setSimplifyInterpolant(4);
-    auto & solver = solverWrapper.getCoreSolver();
-    solver.insertFormula(A);
-    solver.insertFormula(B);
-    auto res = solver.check();
-    ItpQueryResult qres;
+vec<PTRef> SpacerLemmas::generalize(PTRef lemma, PTRef body, PTRef blockedConstraint) const {
+    vec<PTRef> generalized;
+    if (logic.isAnd(lemma)) {
+        vec<PTRef> conjuncts;
+        for (PTRef conjunct : logic.getPterm(lemma)) {
+            conjuncts.push(conjunct);
+        }
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        solverWrapper->getCoreSolver().insertFormula(blockedConstraint);
+        if (solverWrapper->checkUnderAssumptions(conjuncts) == s_False) { return solverWrapper->getUnsatCore(); }
+    } else if (logic.isOr(lemma)) {
+        std::vector<PTRef> disjuncts;
+        for (PTRef disjunct : logic.getPterm(lemma)) {
+            disjuncts.push_back(disjunct);
+        }
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        solverWrapper->getCoreSolver().insertFormula(body);
+        for (std::size_t i = 0; i < disjuncts.size() and disjuncts.size() > 1;) {
+            vec<PTRef> remaining;
+            for (std::size_t j = 0; j < disjuncts.size(); ++j) {
+                if (j != i) { remaining.push(disjuncts[j]); }
+            }
+            PTRef candidate = logic.mkOr(std::move(remaining));
+            if (solverWrapper->checkUnderAssumptions({logic.mkNot(candidate)}) == s_False) {
+                disjuncts.erase(disjuncts.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                ++i;
+            }
+        }
+        vec<PTRef> kept;
+        for (PTRef disjunct : disjuncts) {
+            kept.push(disjunct);
+        }
+        generalized.push(logic.mkOr(std::move(kept)));
+        return generalized;
+    }
+    generalized.push(lemma);
+    return generalized;
+}
+
+/*
+ * A satisfiable lemma implies a component without a common variable only if the component is valid, which summaries
+ * never contain. Such components are skipped without a check.
+ */
+vec<PTRef> SpacerLemmas::subsumedBy(PTRef lemma, vec<PTRef> const & components) const {
+    vec<PTRef> subsumed;
+    if (components.size() == 0) { return subsumed; }
+    if (lemma == logic.getTerm_false()) {
+        for (PTRef component : components) {
+            if (component != lemma) { subsumed.push(component); }
+        }
+        return subsumed;
+    }
+    std::unordered_set<PTRef, PTRefHash> lemmaVars;
+    for (PTRef var : TermUtils(logic).getVars(lemma)) {
+        lemmaVars.insert(var);
+    }
+    auto sharesVariable = [&](PTRef component) {
+        auto vars = TermUtils(logic).getVars(component);
+        return std::any_of(vars.begin(), vars.end(), [&](PTRef var) { return lemmaVars.count(var) != 0; });
+    };
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    solverWrapper->getCoreSolver().insertFormula(lemma);
+    for (PTRef component : components) {
+        if (component == lemma or not sharesVariable(component)) { continue; }
+        if (solverWrapper->checkUnderAssumptions({logic.mkNot(component)}) == s_False) { subsumed.push(component); }
+    }
+    return subsumed;
+}
+
+/*
+ * Adds a lemma to the may summary and removes the components it subsumes, which would only make the summary bigger.
+ */
+void SpacerContext::addLemma(SymRef vid, std::size_t bound, PTRef lemma) {
+    for (PTRef component : SpacerLemmas(logic).subsumedBy(lemma, over.getComponents(vid, bound))) {
+        TRACE(2, "Lemma " << logic.pp(component) << " subsumed by " << logic.pp(lemma))
+        over.remove(vid, bound, component);
+    }
+    addMaySummary(vid, bound, lemma);
+}
+
+/*
+ * Checks the constraint against the edge under the given summaries of its sources. The edge constraint is asserted
+ * only once in the persistent solver of the edge. The summaries are assumptions whose activation literals stay in the
+ * base frame, and only the constraint lives in a temporary frame, so the solver keeps what it has learned about the edge
+ * and the summaries across proof obligations. The solver is rebuilt when the activation literals pile up.
+ */
+SpacerContext::QueryResult SpacerContext::edgeSat(EId eid, vec<PTRef> const & summaryComponents, PTRef constraint) {
+    QueryResult qres;
+    if (std::find(summaryComponents.begin(), summaryComponents.end(), logic.getTerm_false()) != summaryComponents.end()) {
+        qres.answer = QueryAnswer::UNSAT;
+        return qres;
+    }
+    auto it = edgeSolvers.find(eid.id);
+    if (it == edgeSolvers.end() or it->second->activationCount() >= maxEdgeActivations) {
+        TRACE(2, "Building solver for edge " << eid.id)
+        auto solver = std::make_unique<SMTSolver>(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+        solver->getCoreSolver().insertFormula(graph.getEdgeLabel(eid));
+        it = edgeSolvers.insert_or_assign(eid.id, std::move(solver)).first;
+    }
+    auto & solver = *it->second;
+    auto res = solver.checkUnderAssumptions(summaryComponents, constraint);
     if (res == s_True) {
         qres.answer = QueryAnswer::SAT;
+        qres.model = solver.getModel();
     }
     else if (res == s_False) {
         qres.answer = QueryAnswer::UNSAT;
-        auto itpCtx = solver.getInterpolationContext();
-        std::vector<PTRef> itps;
-        ipartitions_t mask = 1;
-        itpCtx->getSingleInterpolant(itps, mask);
-        qres.interpolant = itps[0];
     }
     else if (res == s_Undef) {
         qres.answer = QueryAnswer::UNKNOWN;
@@ -430,69 +749,58 @@ SpacerContext::ItpQueryResult SpacerContext::interpolatingSat(PTRef A, PTRef B)
 bool SpacerContext::checkMustReachability(std::vector<EId> const & edges, ProofObligation const & pob) {
     assert(pob.bound > 0);
     // test if vertex can be reached using must summaries
-    vec<PTRef> summaries;
-    summaries.capacity(edges.size());
     for (EId edgeId : edges) {
         assert(graph.getTarget(edgeId) == pob.vertex);
-        summaries.push(getEdgeMustSummary(edgeId, pob.bound - 1));
-    }
-    PTRef anySummary = logic.mkOr(summaries);
-    auto checkRes = sat(anySummary, pob.constraint);
-    if (checkRes.answer == SpacerContext::QueryAnswer::SAT) {
+        auto checkRes = edgeSat(edgeId, getEdgeMustComponents(edgeId, pob.bound - 1), pob.constraint);
+        if (checkRes.answer != SpacerContext::QueryAnswer::SAT) { continue; }
         TRACE(1, "Must summary successfully applied!")
         assert(checkRes.model);
         // eliminate variables from body except variables present in predicate of pob's vertex
         auto predicateVars = TermUtils(logic).getVars(graph.getNextStateVersion(pob.vertex));
-        int counter = 0;
-        for (PTRef summary : summaries) {
-            if (checkRes.model->evaluate(summary) == logic.getTerm_true()) {
-                PTRef newMustSummary = projectFormula(summary, predicateVars, *checkRes.model);
-                assert(newMustSummary != PTRef_Undef);
-                PTRef definitelyReachable = VersionManager(logic).targetFormulaToBase(newMustSummary);
-                addMustSummary(pob.vertex, pob.bound, definitelyReachable);
-                if (logProof) {
-                    logNewFactIntoDatabase(definitelyReachable, pob.vertex, pob.bound - 1, edges[counter], *checkRes.model);
-                }
-                return true;
-            }
-            ++counter;
+        PTRef summary = getEdgeMustSummary(edgeId, pob.bound - 1);
+        PTRef newMustSummary = projectFormula(summary, predicateVars, *checkRes.model);
+        assert(newMustSummary != PTRef_Undef);
+        PTRef definitelyReachable = versionManager.targetFormulaToBase(newMustSummary);
+        addMustSummary(pob.vertex, pob.bound, definitelyReachable);
+        if (logProof) {
+            logNewFactIntoDatabase(definitelyReachable, pob.vertex, pob.bound - 1, edgeId, *checkRes.model);
         }
-        assert(false); // Should be unreachable, we should encounter satisfied summary above
         return true;
     }
     return false;
 }
 
-bool SpacerContext::mayReachable(EId eid, PTRef targetConstraint, std::size_t bound) const {
-    PTRef maySummary = getEdgeMaySummary(eid, bound);
-    if (maySummary == logic.getTerm_false()) { return false; }
-    auto checkRes = sat(maySummary, targetConstraint);
+bool SpacerContext::mayReachable(EId eid, PTRef targetConstraint, std::size_t bound) {
+    auto checkRes = edgeSat(eid, getEdgeMayComponents(eid, bound), targetConstraint);
     if (checkRes.answer != SpacerContext::QueryAnswer::SAT and checkRes.answer != SpacerContext::QueryAnswer::UNSAT) {
+        if (cancellationToken.stopRequested()) { return false; }
         throw std::logic_error("Spacer: Error in checking implication in mayReachable");
     }
     return checkRes.answer == SpacerContext::QueryAnswer::SAT;
 }
 
-std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofObligation const & pob) const {
+std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofObligation const & pob) {
     assert(pob.bound > 0);
     auto sourceBound = pob.bound - 1;
     auto const & sources = graph.getSources(eid);
     assert(not sources.empty());
     if (sources.size() == 1) { // Edge with single source, we only need to check if pob is reachable with over-approximation
-        PTRef maySummary = getEdgeMaySummary(eid, sourceBound);
-        auto res = sat(maySummary, pob.constraint);
+        auto res = edgeSat(eid, getEdgeMayComponents(eid, sourceBound), pob.constraint);
         if (res.answer == QueryAnswer::SAT) {
             assert(res.model);
             // When this source is over-approximated and the edge becomes feasible -> extract next proof obligation
             auto source = sources[0];
+            PTRef maySummary = getEdgeMaySummary(eid, sourceBound);
             auto predicateVars = TermUtils(logic).getVars(graph.getStateVersion(source));
             PTRef newConstraint = projectFormula(logic.mkAnd(maySummary, pob.constraint), predicateVars, *res.model);
-            PTRef newPob = VersionManager(logic).sourceFormulaToTarget(newConstraint); // ensure POB is target fla
+            PTRef newPob = versionManager.sourceFormulaToTarget(newConstraint); // ensure POB is target fla
             TRACE(2, "New proof obligation generated")
             return ProofObligation{source, sourceBound, newPob};
         } else if (res.answer == QueryAnswer::UNSAT) {
             TRACE(2, "Edge blocked by current may-summaries")
             return std::nullopt;
+        } else if (cancellationToken.stopRequested()) {
+            return std::nullopt;
         }
         assert(false);
         throw std::logic_error("Unreachable!");
@@ -510,15 +818,15 @@ std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofO
     // Find the first source vertex such that over-approximating it (instead of under-approximating it) makes the edge feasible
     std::size_t vertexToRefine = 0; // vertex that is the last one to be over-approximated
     while(true) {
-        PTRef mixedEdgeSummary = getEdgeMixedSummary(eid, sourceBound, vertexToRefine);
-        auto res = sat(mixedEdgeSummary, pob.constraint);
+        auto res = edgeSat(eid, getEdgeMixedComponents(eid, sourceBound, vertexToRefine), pob.constraint);
         if (res.answer == QueryAnswer::SAT) {
             assert(res.model);
+            PTRef mixedEdgeSummary = getEdgeMixedSummary(eid, sourceBound, vertexToRefine);
             // When this source is over-approximated and the edge becomes feasible -> extract next proof obligation
             auto source = sources[vertexToRefine];
             auto predicateVars = TermUtils(logic).getVars(graph.getStateVersion(source, vertexInstances.getInstanceNumber(eid, vertexToRefine)));
             PTRef newConstraint = projectFormula(logic.mkAnd(mixedEdgeSummary, pob.constraint), predicateVars, *res.model);
-            PTRef newPob = VersionManager(logic).sourceFormulaToTarget(newConstraint); // ensure POB is target fla
+            PTRef newPob = versionManager.sourceFormulaToTarget(newConstraint); // ensure POB is target fla
             TRACE(2, "New proof obligation generated")
             return ProofObligation{sources[vertexToRefine], sourceBound, newPob};
         } else if (res.answer == QueryAnswer::UNSAT) {
@@ -526,6 +834,8 @@ std::optional<ProofObligation> SpacerContext::computePredecessor(EId eid, ProofO
             ++vertexToRefine;
             assert(vertexToRefine < sources.size());
             continue;
+        } else if (cancellationToken.stopRequested()) {
+            return std::nullopt;
         }
         assert(false);
         throw std::logic_error("Unreachable!");
@@ -537,23 +847,19 @@ SpacerContext::InductiveCheckResult SpacerContext::isInductive(std::size_t maxLe
     std::size_t minLevel = lowestChangedLevel;
     for (std::size_t level = minLevel; level <= maxLevel; ++level) {
         bool inductive = true;
-//        std::cout << "Checking level " << level << std::endl;
-        for (auto vid : graph.getVertices()) {
-            if (vid == graph.getEntry()) { continue; }
-//            std::cout << " Checking vertex " << vid.id << std::endl;
-            // encode body as disjunction over all the incoming edges
-            vec<PTRef> edgeRepresentations;
-            for (EId eid : incomingEdges(vid, graph)) {
-                edgeRepresentations.push(getEdgeMaySummary(eid, level));
-//                std::cout << "Representation of edge " << eid.id << " at level " << level << " is " << logic.printTerm(edgeRepresentations.last()) << std::endl;
+        if (not pushWorkers.empty()) {
+            auto pushed = tryPushComponentsInParallel(level);
+            if (not pushed.has_value()) { return InductiveCheckResult{InductiveCheckAnswer::NOT_INDUCTIVE, 0}; }
+            inductive = pushed.value();
+        } else {
+            for (auto vid : graph.getVertices()) {
+                if (vid == graph.getEntry()) { continue; }
+                if (cancellationToken.stopRequested()) { return InductiveCheckResult{InductiveCheckAnswer::NOT_INDUCTIVE, 0}; }
+                // Figure out which components of the may summary are implied by body at level n and so can be pushed to level n+1
+                bool allPushed = tryPushComponents(vid, level, getBodyMaySummary(vid, level));
+                inductive = inductive and allPushed;
+                // TODO does it make sense to push other vertices if I already know the current level is not inductive?
             }
-            PTRef body = logic.mkOr(edgeRepresentations);
-//            std::cout << "Body representation of " << vid.id << " at level " << level << " is " << logic.printTerm(body) << std::endl;
-            // Figure out which components of the may summary are implied by body at level n and so can be pushed to level n+1
-//            std::cout << "Need to check " << maySummaryComponents.size() << " components for vertex " << vid.id << std::endl;
-            bool allPushed = tryPushComponents(vid, level, body);
-            inductive = inductive and allPushed;
-            // TODO does it make sense to push other vertices if I already know the current level is not inductive?
         }
         if (inductive) {
             return InductiveCheckResult{InductiveCheckAnswer::INDUCTIVE, level};
@@ -562,6 +868,15 @@ SpacerContext::InductiveCheckResult SpacerContext::isInductive(std::size_t maxLe
     return InductiveCheckResult{InductiveCheckAnswer::NOT_INDUCTIVE, 0};
 }
 
+// Body of the vertex at the given level, encoded as disjunction over all the incoming edges
+PTRef SpacerContext::getBodyMaySummary(SymRef vid, std::size_t level) const {
+    vec<PTRef> edgeRepresentations;
+    for (EId eid : adjacency.getIncomingEdgesFor(vid)) {
+        edgeRepresentations.push(getEdgeMaySummary(eid, level));
+    }
+    return logic.mkOr(edgeRepresentations);
+}
+
 /* This is the original tryPushComponents implementation that tries to push the lemmas one by one */
 #if 0
 bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body) {
@@ -593,58 +908,127 @@ bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body)
 }
 #endif
 
-bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body) {
-    auto maySummaryComponents = over.getComponents(vid, level);
-    vec<PTRef> targetCandidates;
-    targetCandidates.capacity(maySummaryComponents.size());
-    vec<PTRef> activationLiterals;
-    activationLiterals.capacity(maySummaryComponents.size());
-    unsigned counter = 0;
-    for (PTRef component : maySummaryComponents) {
-        if (over.has(vid, level + 1, component)) {
-            continue;
-        }
-        std::string name = ".act" + std::to_string(counter++);
-        PTRef activationVariable = logic.mkBoolVar(name.c_str());
-        targetCandidates.push(VersionManager(logic).baseFormulaToTarget(component));
-        activationLiterals.push(activationVariable);
-    }
-    if (targetCandidates.size() == 0) { return true; }
-
-    bool allPushed = true;
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
-    solver.insertFormula(body);
-    vec<PTRef> queries;
-    queries.capacity(targetCandidates.size());
-    for (auto i = 0; i < targetCandidates.size(); ++i) {
-        queries.push(logic.mkAnd(activationLiterals[i], logic.mkNot(targetCandidates[i])));
+namespace {
+/*
+ * Determines which candidates (target versions of lemmas) are implied by the body.
+ * Returns nothing if the check has been interrupted.
+ */
+std::optional<std::vector<bool>> impliedCandidates(Logic & logic, PTRef body, std::vector<PTRef> const & candidates,
+                                                   CancellationToken const & cancellationToken) {
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    solverWrapper->getCoreSolver().insertFormula(body);
+    // Some candidate that is still enabled is violated
+    vec<PTRef> violations;
+    violations.capacity(static_cast<int>(candidates.size()));
+    for (PTRef candidate : candidates) {
+        violations.push(solverWrapper->activationLiteral(logic.mkNot(candidate)));
     }
-    solver.insertFormula(logic.mkOr(queries));
+    solverWrapper->getCoreSolver().insertFormula(logic.mkOr(violations));
 
-    auto disabled = 0u;
-    while (disabled < queries.size_()) {
-        solver.push();
-        solver.insertFormula(logic.mkAnd(activationLiterals));
-        auto res = solver.check();
+    std::vector<bool> implied(candidates.size(), true);
+    vec<PTRef> disabled;
+    while (static_cast<std::size_t>(disabled.size()) < candidates.size()) {
+        auto res = solverWrapper->checkUnderAssumptions(disabled);
         if (res == s_False) { break; }
+        if (res == s_Undef and cancellationToken.stopRequested()) { return std::nullopt; }
         if (res != s_True) { throw std::logic_error("Solver could not solve a problem while trying to push components!"); }
-        assert(res == s_True);
-        auto model = solver.getModel();
-        for (auto i = 0; i < activationLiterals.size(); ++i) {
-            if (logic.isNot(activationLiterals[i])) { continue; } // already disabled
-            if (model->evaluate(queries[i]) == logic.getTerm_true()) {
-                ++disabled;
-                assert(not logic.isNot(activationLiterals[i]));
-                activationLiterals[i] = logic.mkNot(activationLiterals[i]);
+        auto model = solverWrapper->getModel();
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            if (not implied[i]) { continue; }
+            if (model->evaluate(candidates[i]) == logic.getTerm_false()) {
+                implied[i] = false;
+                disabled.push(logic.mkNot(violations[static_cast<int>(i)]));
             }
         }
-        solver.pop();
     }
+    return implied;
+}
+} // namespace
+
+bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body) {
+    auto candidates = pushCandidates(vid, level);
+    if (candidates.empty()) { return true; }
+    auto implied = impliedCandidates(logic, body, candidates, cancellationToken);
+    if (not implied.has_value()) { return false; }
+    return addPushedComponents(vid, level, candidates, implied.value());
+}
+
+/*
+ * The checks for different vertices at one level are independent. They are distributed among the workers, each
+ * working in its own logic. Only the workers touch the term store while they run, the terms of this context are
+ * only read by the translators. Returns nothing if the checks have been interrupted.
+ */
+std::optional<bool> SpacerContext::tryPushComponentsInParallel(std::size_t level) {
+    struct Job {
+        SymRef vid;
+        PTRef body;
+        std::vector<PTRef> candidates;
+        std::optional<std::vector<bool>> implied;
+    };
+    std::vector<Job> jobs;
+    for (auto vid : graph.getVertices()) {
+        if (vid == graph.getEntry()) { continue; }
+        auto candidates = pushCandidates(vid, level);
+        if (candidates.empty()) { continue; }
+        jobs.push_back({vid, getBodyMaySummary(vid, level), std::move(candidates), std::nullopt});
+    }
+    std::atomic<std::size_t> nextJob{0};
+    std::vector<std::exception_ptr> errors(pushWorkers.size());
+    std::vector<std::thread> threads;
+    threads.reserve(pushWorkers.size());
+    for (std::size_t w = 0; w < pushWorkers.size(); ++w) {
+        threads.emplace_back([&, w]() {
+            CancellationToken::Scope scope(cancellationToken);
+            auto & worker = *pushWorkers[w];
+            try {
+                for (auto i = nextJob++; i < jobs.size(); i = nextJob++) {
+                    auto & job = jobs[i];
+                    std::vector<PTRef> candidates;
+                    candidates.reserve(job.candidates.size());
+                    for (PTRef candidate : job.candidates) {
+                        candidates.push_back(worker.translator.translate(candidate));
+                    }
+                    job.implied = impliedCandidates(worker.logic, worker.translator.translate(job.body), candidates,
+                                                    cancellationToken);
+                }
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    for (auto const & error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+    bool inductive = true;
+    for (auto const & job : jobs) {
+        if (not job.implied.has_value()) { return std::nullopt; }
+        bool allPushed = addPushedComponents(job.vid, level, job.candidates, job.implied.value());
+        inductive = inductive and allPushed;
+    }
+    return inductive;
+}
+
+// Target versions of the components of the may summary at the given level that are not yet at the next level
+std::vector<PTRef> SpacerContext::pushCandidates(SymRef vid, std::size_t level) {
+    std::vector<PTRef> candidates;
+    for (PTRef component : over.getComponents(vid, level)) {
+        if (over.has(vid, level + 1, component)) {
+            continue;
+        }
+        candidates.push_back(versionManager.baseFormulaToTarget(component));
+    }
+    return candidates;
+}
 
-    for (auto i = 0; i < targetCandidates.size(); ++i) {
-        if (not logic.isNot(activationLiterals[i])) {
-            addMaySummary(vid, level + 1, VersionManager(logic).targetFormulaToBase(targetCandidates[i]));
+bool SpacerContext::addPushedComponents(SymRef vid, std::size_t level, std::vector<PTRef> const & candidates,
+                                        std::vector<bool> const & implied) {
+    bool allPushed = true;
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (implied[i]) {
+            addMaySummary(vid, level + 1, versionManager.targetFormulaToBase(candidates[i]));
         } else {
             allPushed = false;
         }
@@ -652,9 +1036,6 @@ bool SpacerContext::tryPushComponents(SymRef vid, std::size_t level, PTRef body)
     return allPushed;
 }
 
-
-
-
 PTRef SpacerContext::projectFormula(PTRef fla, const vec<PTRef> &toVars, Model & model) const {
     assert(std::all_of(toVars.begin(), toVars.end(), [this](PTRef var) { return logic.isVar(var); }));
 //    std::cout << "Projecting " << logic.printTerm(fla) << " to variables ";
@@ -676,65 +1057,62 @@ PTRef SpacerContext::projectFormula(PTRef fla, const vec<PTRef> &toVars, Model &
 }
 
 PTRef SpacerContext::getEdgeMustSummary(EId eid, std::size_t bound) const {
-//    std::cout << "Must summary:\n ";
-    PTRef edgeLabel = graph.getEdgeLabel(eid); // Edge labels are versioned
-//    std::cout << "Edge label: " << logic.pp(edgeLabel) << '\n';
-    vec<PTRef> bodyComponents{edgeLabel};
-//    std::cout << "Edge sources:\n";
-    auto const & sources = graph.getSources(eid);
-    for (unsigned sourceIndex = 0; sourceIndex < sources.size(); ++sourceIndex) {
-        auto source = sources[sourceIndex];
-        PTRef mustSummary = getMustSummary(source, bound);
-        PTRef summaryAsSource = VersionManager(logic).baseFormulaToSource(mustSummary, vertexInstances.getInstanceNumber(eid, sourceIndex));
-//        std::cout << source.id << " with summary " << logic.pp(summaryAsSource) << '\n';
-        bodyComponents.push(summaryAsSource);
-    }
-//    std::cout << std::flush;
+    vec<PTRef> bodyComponents = getEdgeMustComponents(eid, bound);
+    bodyComponents.push(graph.getEdgeLabel(eid)); // Edge labels are versioned
     return logic.mkAnd(std::move(bodyComponents));
 }
 
 PTRef SpacerContext::getEdgeMaySummary(EId eid, std::size_t bound) const {
-//    std::cout << "May summary:\n ";
-    PTRef edgeLabel = graph.getEdgeLabel(eid);
-//    std::cout << "Edge label: " << logic.pp(edgeLabel) << '\n';
-    vec<PTRef> bodyComponents{edgeLabel};
-//    std::cout << "Edge sources:\n";
-    auto const & sources = graph.getSources(eid);
-    for (unsigned sourceIndex = 0; sourceIndex < sources.size(); ++sourceIndex) {
-        auto source = sources[sourceIndex];
-        PTRef maySummary = getMaySummary(source, bound);
-        PTRef summaryAsSource = VersionManager(logic).baseFormulaToSource(maySummary, vertexInstances.getInstanceNumber(eid, sourceIndex));
-//        std::cout << source.id << " with summary " << logic.pp(summaryAsSource) << '\n';
-        bodyComponents.push(summaryAsSource);
-    }
-//    std::cout << std::flush;
+    vec<PTRef> bodyComponents = getEdgeMayComponents(eid, bound);
+    bodyComponents.push(graph.getEdgeLabel(eid));
     return logic.mkAnd(std::move(bodyComponents));
 }
 
 PTRef SpacerContext::getEdgeMixedSummary(EId eid, std::size_t bound, std::size_t lastMayIndex) const {
+    vec<PTRef> components = getEdgeMixedComponents(eid, bound, lastMayIndex);
+    components.push(graph.getEdgeLabel(eid));
+    return logic.mkAnd(std::move(components));
+}
+
+/*
+ * The summaries of the sources of an edge, versioned as the sources of the edge, without the edge constraint itself.
+ * Must summaries are disjunctions, each source contributes one component. May summaries are conjunctions, each lemma
+ * is a separate component, so that it can be reused as an assumption in the persistent edge solvers.
+ */
+vec<PTRef> SpacerContext::getEdgeMustComponents(EId eid, std::size_t bound) const {
+    return getEdgeSourceComponents(eid, bound, 0);
+}
+
+vec<PTRef> SpacerContext::getEdgeMayComponents(EId eid, std::size_t bound) const {
+    return getEdgeSourceComponents(eid, bound, graph.getSources(eid).size());
+}
+
+vec<PTRef> SpacerContext::getEdgeMixedComponents(EId eid, std::size_t bound, std::size_t lastMayIndex) const {
+    return getEdgeSourceComponents(eid, bound, lastMayIndex + 1);
+}
+
+// The first mayCount sources are represented by their may summaries, the rest by their must summaries
+vec<PTRef> SpacerContext::getEdgeSourceComponents(EId eid, std::size_t bound, std::size_t mayCount) const {
     auto const & sources = graph.getSources(eid);
-    auto sourceCount = sources.size();
     vec<PTRef> components;
-    components.capacity(static_cast<int>(sourceCount) + 1);
-    for (std::size_t i = 0; i <= lastMayIndex; ++i) {
-        PTRef maySummary = getMaySummary(sources[i], bound);
-        PTRef summaryAsSource = VersionManager(logic).baseFormulaToSource(maySummary, vertexInstances.getInstanceNumber(eid, i));
-        components.push(summaryAsSource);
-    }
-    for (std::size_t i = lastMayIndex + 1; i < sources.size(); ++i) {
-        PTRef mustSummary = getMustSummary(sources[i], bound);
-        PTRef summaryAsSource = VersionManager(logic).baseFormulaToSource(mustSummary, vertexInstances.getInstanceNumber(eid, i));
-        components.push(summaryAsSource);
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        unsigned instance = vertexInstances.getInstanceNumber(eid, static_cast<unsigned>(i));
+        if (i < mayCount) {
+            for (PTRef lemma : over.getComponents(sources[i], bound)) {
+                components.push(versionManager.baseFormulaToSource(lemma, instance));
+            }
+        } else {
+            PTRef mustSummary = getMustSummary(sources[i], bound);
+            components.push(versionManager.baseFormulaToSource(mustSummary, instance));
+        }
     }
-    components.push(graph.getEdgeLabel(eid));
-    return logic.mkAnd(std::move(components));
+    return components;
 }
 
 void SpacerContext::logNewFactIntoDatabase(PTRef fact, SymRef vertex, std::size_t level, EId edgeId, Model & model) {
     DerivationDatabase::DerivedFact newFact = {fact, vertex};
     std::vector<DerivationDatabase::ID> premises;
     // figure out the premises
-    VersionManager versionManager(logic);
     auto const & sourceNodes = graph.getSources(edgeId);
     for (std::size_t index = 0; index < sourceNodes.size(); ++index) {
         auto sourceNode = sourceNodes[index];
@@ -776,8 +1154,8 @@ void computePremiseInstances(DerivationDatabase::Entry const & databaseEntry, En
     assert(entry.premiseInstances.empty());
     Logic & logic = graph.getLogic();
     EId edge = databaseEntry.incomingEdge;
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     VersionManager versionManager(logic);
     vec<PTRef> sourcePredicates;
     for (std::size_t i = 0; i < databaseEntry.premises.size(); ++i) {
@@ -9,6 +9,28 @@
 
 #include "Engine.h"
 
+/**
+ * Strengthening and filtering of the lemmas learned by Spacer.
+ */
+class SpacerLemmas {
+    Logic & logic;
+
+public:
+    explicit SpacerLemmas(Logic & logic) : logic(logic) {}
+
+    /**
+     * Generalizes a lemma computed as an interpolant between a body and a blocked constraint. A conjunction is reduced
+     * to the conjuncts needed to block the constraint; each of them is returned as a separate lemma. A disjunction is
+     * strengthened by dropping the disjuncts that are not needed for the body to imply the lemma.
+     */
+    vec<PTRef> generalize(PTRef lemma, PTRef body, PTRef blockedConstraint) const;
+
+    /**
+     * The components implied by the lemma, other than the lemma itself.
+     */
+    vec<PTRef> subsumedBy(PTRef lemma, vec<PTRef> const & components) const;
+};
+
 class Spacer : public Engine {
     Logic & logic;
     Options const & options;
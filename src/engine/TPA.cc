@@ -16,6 +16,14 @@
 #include "transformers/BasicTransformationPipelines.h"
 #include "transformers/SingleLoopTransformation.h"
 #include "utils/SmtSolver.h"
+#include "utils/TermTranslator.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <unordered_set>
+#include <utility>
 
 #define TRACE_LEVEL 0
 
@@ -30,13 +38,27 @@ bool TPAEngine::shouldComputeWitness() const {
 }
 
 std::unique_ptr<TPABase> TPAEngine::mkSolver() {
+    return mkSolver(logic);
+}
+
+std::unique_ptr<TPABase> TPAEngine::mkSolver(Logic & solverLogic) {
+    std::unique_ptr<TPABase> solver;
     switch (coreAlgorithm) {
         case TPACore::BASIC:
-            return std::make_unique<TPABasic>(logic, options);
+            solver = std::make_unique<TPABasic>(solverLogic, options);
+            break;
         case TPACore::SPLIT:
-            return std::make_unique<TPASplit>(logic, options);
+            solver = std::make_unique<TPASplit>(solverLogic, options);
+            break;
+        default:
+            throw std::logic_error("UNREACHABLE");
     }
-    throw std::logic_error("UNREACHABLE");
+    solver->setCancellationToken(cancellationToken);
+    if (&solverLogic == &logic) { // The shared cache is keyed by the terms of the engine's logic
+        if (not queryCache) { queryCache = TPAQueryCache::fromOptions(logic, options); }
+        solver->setQueryCache(queryCache);
+    }
+    return solver;
 }
 
 VerificationResult TPAEngine::solve(ChcDirectedHyperGraph const & graph) {
@@ -57,7 +79,10 @@ VerificationResult TPAEngine::solve(const ChcDirectedGraph & graph) {
     if (isTransitionSystem(graph)) {
         auto ts = toTransitionSystem(graph);
         auto solver = mkSolver();
+        PTRef sharedInvariant = logic.getTerm_true();
+        if (lemmaBus) { solver->setInvariantSource(sharedInvariantSource(graph, *ts, sharedInvariant)); }
         auto res = solver->solveTransitionSystem(*ts);
+        if (res == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested()) { return interrupted(*solver); }
         if (not shouldComputeWitness()) { return VerificationResult(res); }
         switch (res) {
             case VerificationAnswer::UNSAFE:
@@ -66,9 +91,12 @@ VerificationResult TPAEngine::solve(const ChcDirectedGraph & graph) {
                 PTRef inductiveInvariant = solver->getInductiveInvariant();
                 if (inductiveInvariant == PTRef_Undef) { return VerificationResult(res); }
                 // std::cout << "TS invariant: " << logic.printTerm(inductiveInvariant) << std::endl;
+                // Invariant of the strengthened system together with the shared invariant is inductive in the original
+                inductiveInvariant = logic.mkAnd(inductiveInvariant, sharedInvariant);
                 return VerificationResult(res, computeValidityWitness(graph, *ts, inductiveInvariant));
             }
             case VerificationAnswer::UNKNOWN:
+                return VerificationResult(res);
             default:
                 assert(false);
                 throw std::logic_error("Unreachable!");
@@ -82,6 +110,7 @@ VerificationResult TPAEngine::solve(const ChcDirectedGraph & graph) {
     assert(ts);
     auto solver = mkSolver();
     auto res = solver->solveTransitionSystem(*ts);
+    if (res == VerificationAnswer::UNKNOWN and cancellationToken.stopRequested()) { return interrupted(*solver); }
     if (not shouldComputeWitness()) { return VerificationResult(res); }
     switch (res) {
         case VerificationAnswer::UNSAFE:
@@ -92,12 +121,69 @@ VerificationResult TPAEngine::solve(const ChcDirectedGraph & graph) {
             return backtranslator->translate({res, inductiveInvariant});
         }
         case VerificationAnswer::UNKNOWN:
+            return VerificationResult(res);
         default:
             assert(false);
             throw std::logic_error("Unreachable!");
     }
 }
 
+/*
+ * Received facts are used once they form, together with the facts accepted before, an invariant that holds initially and
+ * is inductive on its own. The invariant of the restricted system together with the accepted facts is then an invariant
+ * of the original system. Facts published together by another engine may arrive over several polls, so the facts that
+ * are not yet inductive are kept for the next poll.
+ */
+std::function<PTRef()> TPAEngine::sharedInvariantSource(ChcDirectedGraph const & graph,
+                                                        TransitionSystem const & system,
+                                                        PTRef & acceptedInvariant) const {
+    auto vertices = graph.getVertices();
+    auto it = std::find_if(vertices.begin(), vertices.end(),
+                           [&](SymRef vertex) { return vertex != graph.getEntry() and vertex != graph.getExit(); });
+    assert(it != vertices.end());
+    auto stateVars = system.getStateVars();
+    if (it == vertices.end() or stateVars.empty()) { return {}; }
+    auto nextStateVars = system.getNextStateVars();
+    TermUtils::substitutions_map toNext;
+    vec<PTRef> args;
+    for (std::size_t i = 0; i < stateVars.size(); ++i) {
+        toNext.insert({stateVars[i], nextStateVars[i]});
+        args.push(stateVars[i]);
+    }
+    PTRef instance = logic.mkUninterpFun(*it, std::move(args));
+    auto subscription = std::make_shared<LemmaBus::Subscription>(*lemmaBus, logic);
+    return [this, subscription, instance, toNext, init = system.getInit(), transition = system.getTransition(),
+            pending = std::vector<PTRef>(), &acceptedInvariant]() mutable {
+        vec<PTRef> instances;
+        instances.push(instance);
+        auto received = subscription->receive(instances);
+        if (received.empty()) { return logic.getTerm_true(); }
+        for (auto const & fact : received) {
+            pending.push_back(fact.fact);
+        }
+        vec<PTRef> fresh;
+        for (PTRef fact : pending) {
+            fresh.push(fact);
+        }
+        PTRef freshInvariant = logic.mkAnd(std::move(fresh));
+        PTRef candidate = logic.mkAnd(acceptedInvariant, freshInvariant);
+        PTRef nextCandidate = TermUtils(logic).varSubstitute(candidate, toNext);
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
+        solver.insertFormula(logic.mkOr(logic.mkAnd(init, logic.mkNot(candidate)),
+                                        logic.mkAnd({candidate, transition, logic.mkNot(nextCandidate)})));
+        if (solver.check() != s_False) { return logic.getTerm_true(); }
+        acceptedInvariant = candidate;
+        pending.clear();
+        return freshInvariant;
+    };
+}
+
+VerificationResult TPAEngine::interrupted(TPABase const & solver) const {
+    return interruptedResult(cancellationToken,
+                             "TPA: Stopped while checking power " + std::to_string(solver.getCurrentPower()));
+}
+
 class SolverWrapperSingleUse : public SolverWrapper {
     Logic & logic;
     SMTSolver solverWrapper;
@@ -220,11 +306,181 @@ public:
     }
 };
 
+std::shared_ptr<TPAQueryCache> TPAQueryCache::fromOptions(Logic & logic, Options const & options) {
+    return std::make_shared<TPAQueryCache>(logic, std::stoul(options.getOrDefault(Options::TPA_CACHE_SIZE, "100000")));
+}
+
+std::optional<TPAQueryResult> TPAQueryCache::find(Key const & key) {
+    auto it = index.find(key);
+    if (it == index.end() or it->second->result.result != ReachabilityResult::REACHABLE) {
+        ++missCount;
+        return std::nullopt;
+    }
+    ++hitCount;
+    touch(it->second);
+    return it->second->result;
+}
+
+bool TPAQueryCache::knownUnreachable(Key const & key, Producer const & producer) {
+    auto it = index.find(key);
+    if (it != index.end() and it->second->result.result == ReachabilityResult::UNREACHABLE and
+        it->second->producer == producer) {
+        ++hitCount;
+        touch(it->second);
+        return true;
+    }
+    auto levelIt = unreachableOnLevel.find(levelOf(key));
+    if (levelIt == unreachableOnLevel.end()) { return false; }
+    auto const & candidates = levelIt->second;
+    if (std::any_of(candidates.begin(), candidates.end(), [&](Key const & candidate) {
+            return index.at(candidate)->producer == producer and subsumes(candidate, key);
+        })) {
+        ++hitCount;
+        return true;
+    }
+    return false;
+}
+
+bool TPAQueryCache::subsumes(Key const & weaker, Key const & stronger) const {
+    auto includesConjuncts = [&](PTRef weakerFla, PTRef strongerFla) {
+        if (weakerFla == strongerFla) { return true; }
+        TermUtils utils(logic);
+        std::unordered_set<PTRef, PTRefHash> present;
+        for (PTRef conjunct : utils.getTopLevelConjuncts(strongerFla)) {
+            present.insert(conjunct);
+        }
+        for (PTRef conjunct : utils.getTopLevelConjuncts(weakerFla)) {
+            if (present.count(conjunct) == 0) { return false; }
+        }
+        return true;
+    };
+    return includesConjuncts(weaker.from, stronger.from) and includesConjuncts(weaker.to, stronger.to);
+}
+
+void TPAQueryCache::insert(Key const & key, TPAQueryResult result, Producer const & producer) {
+    if (capacity == 0) { return; }
+    auto it = index.find(key);
+    if (it != index.end()) {
+        auto & entry = *it->second;
+        bool wasUnreachable = entry.result.result == ReachabilityResult::UNREACHABLE;
+        bool isUnreachable = result.result == ReachabilityResult::UNREACHABLE;
+        if (wasUnreachable and not isUnreachable) { forgetUnreachable(key); }
+        if (isUnreachable and not wasUnreachable) { unreachableOnLevel[levelOf(key)].push_back(key); }
+        entry.result = result;
+        entry.producer = producer;
+        touch(it->second);
+        return;
+    }
+    if (entries.size() >= capacity) { evict(); }
+    entries.push_front(Entry{key, result, producer});
+    index.emplace(key, entries.begin());
+    if (result.result == ReachabilityResult::UNREACHABLE) { unreachableOnLevel[levelOf(key)].push_back(key); }
+}
+
+void TPAQueryCache::forgetUnreachable(Key const & key) {
+    auto levelIt = unreachableOnLevel.find(levelOf(key));
+    assert(levelIt != unreachableOnLevel.end());
+    auto & keys = levelIt->second;
+    keys.erase(std::find(keys.begin(), keys.end(), key));
+    if (keys.empty()) { unreachableOnLevel.erase(levelIt); }
+}
+
+void TPAQueryCache::evict() {
+    assert(not entries.empty());
+    auto const & victim = entries.back();
+    if (victim.result.result == ReachabilityResult::UNREACHABLE) { forgetUnreachable(victim.key); }
+    index.erase(victim.key);
+    entries.pop_back();
+}
+
+RebuildPolicy RebuildPolicy::fromOptions(Options const & options) {
+    std::string value = options.getOrDefault(Options::TPA_REBUILD, "adaptive");
+    RebuildPolicy policy;
+    if (value == "adaptive") {
+        policy.kind = Kind::ADAPTIVE;
+    } else if (value == "never") {
+        policy.kind = Kind::NEVER;
+    } else {
+        try {
+            policy.levelLimit = std::stoul(value);
+        } catch (std::exception const &) { throw std::logic_error("Unknown TPA rebuild policy: " + value); }
+        policy.kind = Kind::FIXED;
+    }
+    return policy;
+}
+
+namespace {
+std::size_t termSize(Logic & logic, PTRef fla) {
+    std::unordered_set<PTRef, PTRefHash> seen;
+    std::vector<PTRef> queue{fla};
+    while (not queue.empty()) {
+        PTRef current = queue.back();
+        queue.pop_back();
+        if (not seen.insert(current).second) { continue; }
+        for (PTRef child : logic.getPterm(current)) {
+            queue.push_back(child);
+        }
+    }
+    return seen.size();
+}
+} // namespace
+
+/*
+ * Incremental solver that is periodically rebuilt from scratch with the transition components consolidated into a
+ * single formula at the base level. The moment of the rebuild is decided by the RebuildPolicy.
+ * The adaptive policy rebuilds when the push frames become too deep, when they hold most of the asserted formula, or
+ * when the checks have become significantly slower than right after the last rebuild.
+ */
 class SolverWrapperIncrementalWithRestarts : public SolverWrapperIncremental {
+    using Clock = std::chrono::steady_clock;
+
     vec<PTRef> transitionComponents;
-    const unsigned limit = 100;
+    RebuildPolicy const policy;
     unsigned levels = 0;
 
+    // Statistics since the last rebuild
+    std::size_t baseSize = 0;
+    std::size_t framesSize = 0;
+    unsigned checks = 0;
+    double baselineCheckTime = 0; // Average over the first checks, in microseconds
+    double recentCheckTime = 0;   // Exponential moving average, in microseconds
+
+    static constexpr unsigned minDepth = 8;
+    static constexpr unsigned maxDepth = 1000;
+    static constexpr unsigned warmupChecks = 3;
+    static constexpr double slowdownFactor = 3.0;
+    static constexpr double negligibleCheckTime = 1000;
+    static constexpr double smoothing = 0.25;
+
+    unsigned pushDepth() const { return static_cast<unsigned>(transitionComponents.size()) - 1; }
+
+    bool shouldRebuild() const {
+        if (pushDepth() == 0) { return false; }
+        switch (policy.kind) {
+            case RebuildPolicy::Kind::NEVER:
+                return false;
+            case RebuildPolicy::Kind::FIXED:
+                return levels > policy.levelLimit;
+            case RebuildPolicy::Kind::ADAPTIVE:
+                if (pushDepth() >= maxDepth) { return true; }
+                if (pushDepth() < minDepth) { return false; }
+                if (framesSize > baseSize) { return true; }
+                return checks > warmupChecks and recentCheckTime > negligibleCheckTime and
+                       recentCheckTime > slowdownFactor * baselineCheckTime;
+        }
+        return false;
+    }
+
+    void recordCheckTime(double time) {
+        ++checks;
+        if (checks <= warmupChecks) {
+            baselineCheckTime += (time - baselineCheckTime) / checks;
+            recentCheckTime = baselineCheckTime;
+        } else {
+            recentCheckTime = smoothing * time + (1 - smoothing) * recentCheckTime;
+        }
+    }
+
     void rebuildSolver() {
         solverWrapper.resetSolver();
         PTRef consolidatedTransition = logic.mkAnd(transitionComponents);
@@ -235,31 +491,165 @@ class SolverWrapperIncrementalWithRestarts : public SolverWrapperIncremental {
         opensmt::setbit(mask, allformulasInserted++);
         transitionComponents.clear();
         transitionComponents.push(consolidatedTransition);
+        baseSize = termSize(logic, consolidatedTransition);
+        framesSize = 0;
+        checks = 0;
+        baselineCheckTime = 0;
+        recentCheckTime = 0;
     }
 
 public:
-    SolverWrapperIncrementalWithRestarts(Logic & logic, PTRef transition)
-        : SolverWrapperIncremental(logic, transition) {
+    SolverWrapperIncrementalWithRestarts(Logic & logic, PTRef transition, RebuildPolicy policy)
+        : SolverWrapperIncremental(logic, transition), policy(policy) {
         transitionComponents.push(transition);
+        baseSize = termSize(logic, transition);
     }
 
     ReachabilityResult checkConsistent(PTRef query) override {
         ++levels;
-        if (levels > limit) {
-            //            std::cout << "Rebuilding solver after " << levels << " pushes" << std::endl;
+        if (shouldRebuild()) {
+            TRACE(1, "Rebuilding solver after " << levels << " levels with push depth " << pushDepth())
             rebuildSolver();
         }
-        return SolverWrapperIncremental::checkConsistent(query);
+        auto start = Clock::now();
+        auto result = SolverWrapperIncremental::checkConsistent(query);
+        recordCheckTime(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        return result;
     }
 
     void strengthenTransition(PTRef nTransition) override {
         SolverWrapperIncremental::strengthenTransition(nTransition);
         transitionComponents.push(nTransition);
+        framesSize += termSize(logic, nTransition);
         ++levels;
     }
 };
 
+/*
+ * Helper threads that check reachability queries over two steps of a transition while the main thread of split-TPA
+ * continues with its own queries. The term store is not thread-safe, so each helper owns its logic, and the terms are
+ * translated to and from this logic only by the main thread, while the helper is idle.
+ */
+class SpeculativeChecks;
+
+class SpeculativeCheck {
+    SpeculativeChecks * owner = nullptr;
+    std::size_t index = 0;
+
+public:
+    SpeculativeCheck() = default;
+    SpeculativeCheck(SpeculativeChecks * owner, std::size_t index) : owner(owner), index(index) {}
+    SpeculativeCheck(SpeculativeCheck && other) noexcept
+        : owner(std::exchange(other.owner, nullptr)), index(other.index) {}
+    SpeculativeCheck & operator=(SpeculativeCheck &&) = delete;
+    ~SpeculativeCheck();
+
+    /*
+     * Interpolant of the transition and the query, if the helper found the query unsatisfiable.
+     * Unless asked to wait, a check that is still running is stopped and yields nothing.
+     */
+    PTRef result(bool wait);
+};
+
+class SpeculativeChecks {
+    struct Helper {
+        ArithLogic logic;
+        TermTranslator toHelper;
+        TermTranslator fromHelper;
+        CancellationToken token;
+        std::future<PTRef> pending; // Interpolant over the first step, PTRef_Undef if the query was not unsatisfiable
+
+        explicit Helper(ArithLogic & source)
+            : logic(source.hasIntegers() ? opensmt::Logic_t::QF_LIA : opensmt::Logic_t::QF_LRA),
+              toHelper(source, logic), fromHelper(logic, source) {}
+    };
+
+    std::vector<std::unique_ptr<Helper>> helpers;
+
+    friend class SpeculativeCheck;
+
+public:
+    SpeculativeChecks(ArithLogic & logic, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            helpers.push_back(std::make_unique<Helper>(logic));
+        }
+    }
+
+    ~SpeculativeChecks() {
+        for (std::size_t i = 0; i < helpers.size(); ++i) {
+            discard(i);
+        }
+    }
+
+    /*
+     * Starts the check of the query with the transition in a free helper; returns an empty check if all are busy.
+     */
+    SpeculativeCheck submit(PTRef transition, PTRef query, CancellationToken const & parent) {
+        for (std::size_t i = 0; i < helpers.size(); ++i) {
+            auto & helper = *helpers[i];
+            if (helper.pending.valid()) { continue; }
+            helper.token = parent.createChild();
+            PTRef helperTransition = helper.toHelper.translate(transition);
+            PTRef helperQuery = helper.toHelper.translate(query);
+            helper.pending = std::async(std::launch::async, [&helper, helperTransition, helperQuery]() {
+                CancellationToken::Scope scope(helper.token);
+                SMTSolver solverWrapper(helper.logic, SMTSolver::WitnessProduction::ONLY_INTERPOLANTS);
+                solverWrapper.getConfig().setSimplifyInterpolant(4);
+                solverWrapper.getConfig().setLRAInterpolationAlgorithm(itp_lra_alg_decomposing_strong);
+                auto & solver = solverWrapper.getCoreSolver();
+                solver.insertFormula(helperTransition);
+                solver.insertFormula(helperQuery);
+                if (solver.check() != s_False) { return PTRef_Undef; }
+                vec<PTRef> itps;
+                ipartitions_t mask = 1; // The transition was the first formula inserted
+                solver.getInterpolationContext()->getSingleInterpolant(itps, mask);
+                assert(itps.size() == 1);
+                return itps[0];
+            });
+            return SpeculativeCheck(this, i);
+        }
+        return SpeculativeCheck();
+    }
+
+private:
+    PTRef collect(std::size_t index, bool wait) {
+        auto & helper = *helpers[index];
+        assert(helper.pending.valid());
+        if (not wait and helper.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            discard(index);
+            return PTRef_Undef;
+        }
+        PTRef itp = helper.pending.get();
+        return itp == PTRef_Undef ? PTRef_Undef : helper.fromHelper.translate(itp);
+    }
+
+    void discard(std::size_t index) {
+        auto & helper = *helpers[index];
+        if (not helper.pending.valid()) { return; }
+        helper.token.requestStop();
+        try {
+            helper.pending.get();
+        } catch (...) {} // Nobody is interested in the result of this check anymore
+    }
+};
+
+SpeculativeCheck::~SpeculativeCheck() {
+    if (owner) { owner->discard(index); }
+}
+
+PTRef SpeculativeCheck::result(bool wait) {
+    return owner ? std::exchange(owner, nullptr)->collect(index, wait) : PTRef_Undef;
+}
+
+TPASplit::TPASplit(Logic & logic, Options const & options) : TPABase(logic, options) {
+    auto threads = std::stoul(options.getOrDefault(Options::TPA_THREADS, "1"));
+    if (auto * arithLogic = dynamic_cast<ArithLogic *>(&logic); arithLogic and threads > 1) {
+        speculativeChecks = std::make_unique<SpeculativeChecks>(*arithLogic, threads - 1);
+    }
+}
+
 TPASplit::~TPASplit() {
+    speculativeChecks.reset();
     for (SolverWrapper * solver : reachabilitySolvers) {
         delete solver;
     }
@@ -279,7 +669,6 @@ PTRef TPABase::getQuery() const {
 
 vec<PTRef> TPABase::getStateVars(int version) const {
     vec<PTRef> versioned;
-    TimeMachine timeMachine(logic);
     for (PTRef var : stateVariables) {
         versioned.push(timeMachine.sendVarThroughTime(var, version));
     }
@@ -289,7 +678,7 @@ vec<PTRef> TPABase::getStateVars(int version) const {
 PTRef TPABase::getNextVersion(PTRef currentVersion, int shift) const {
     auto it = versioningCache.find({currentVersion, shift});
     if (it != versioningCache.end()) { return it->second; }
-    PTRef res = TimeMachine(logic).sendFlaThroughTime(currentVersion, shift);
+    PTRef res = timeMachine.sendFlaThroughTime(currentVersion, shift);
     versioningCache.insert({{currentVersion, shift}, res});
     return res;
 }
@@ -337,17 +726,46 @@ void TPABase::resetExplanation() {
 void TPABase::resetInitialStates(PTRef fla) {
     assert(isPureStateFormula(fla));
     this->init = fla;
-    queryCache.clear();
     resetExplanation();
 }
 
 void TPABase::updateQueryStates(PTRef fla) {
     assert(isPureStateFormula(fla));
     this->query = logic.mkAnd(fla, this->query);
-    queryCache.clear();
     resetExplanation();
 }
 
+std::optional<TPABase::QueryResult> TPABase::findCachedQuery(TPAType type, unsigned short power, PTRef from,
+                                                               PTRef to) const {
+    return queryCache->find({transition, type, power, from, to});
+}
+
+void TPABase::cacheQuery(TPAType type, unsigned short power, PTRef from, PTRef to, QueryResult result) const {
+    queryCache->insert({transition, type, power, from, to}, result, {this, abstractionVersion});
+}
+
+/*
+ * Answers the query from the initial to the query states from the cache, if possible, or runs it and caches its result.
+ * A cached unreachable answer is only used if this solver produced it with its current abstraction, which the query
+ * then strengthened, and if this solver has already built the abstraction of the next level.
+ * Inside the recursion, only reachable answers are taken from the cache: the callers rely on an unreachable query
+ * having strengthened their abstraction.
+ */
+TPABase::QueryResult TPABase::cachedTopLevelQuery(TPAType type, unsigned short power, bool nextLevelBuilt,
+                                                  std::function<QueryResult()> const & runQuery) {
+    if (auto cached = findCachedQuery(type, power, init, query)) { return *cached; }
+    TPAQueryCache::Producer self{this, abstractionVersion};
+    if (nextLevelBuilt and queryCache->knownUnreachable({transition, type, power, init, query}, self)) {
+        TRACE(1, "Unreachability of the query known on level " << power)
+        QueryResult result;
+        result.result = ReachabilityResult::UNREACHABLE;
+        return result;
+    }
+    auto result = runQuery();
+    cacheQuery(type, power, init, query, result);
+    return result;
+}
+
 PTRef TPASplit::getExactPower(unsigned short power) const {
     assert(power < exactPowers.size());
     return exactPowers[power];
@@ -368,7 +786,7 @@ void TPASplit::storeExactPower(unsigned short power, PTRef tr) {
     PTRef nextLevelTransitionStrengthening = logic.mkAnd(tr, getNextVersion(tr));
     if (not reachabilitySolvers[power + 1]) {
         reachabilitySolvers[power + 1] =
-            new SolverWrapperIncrementalWithRestarts(logic, nextLevelTransitionStrengthening);
+            new SolverWrapperIncrementalWithRestarts(logic, nextLevelTransitionStrengthening, rebuildPolicy);
         //        reachabilitySolvers[power + 1] = new SolverWrapperIncremental(logic,
         //        nextLevelTransitionStrengthening); reachabilitySolvers[power + 1] = new SolverWrapperSingleUse(logic,
         //        nextLevelTransitionStrengthening);
@@ -399,6 +817,12 @@ SolverWrapper * TPASplit::getExactReachabilitySolver(unsigned short power) const
     return reachabilitySolvers[power];
 }
 
+// Unique across solvers, so that a solver allocated at the address of a destroyed one cannot claim its results
+static std::size_t nextAbstractionVersion() {
+    static std::atomic<std::size_t> abstractionVersions{0};
+    return ++abstractionVersions;
+}
+
 VerificationAnswer TPABase::solveTransitionSystem(TransitionSystem & system) {
     resetTransitionSystem(system);
     return solve();
@@ -408,19 +832,52 @@ VerificationAnswer TPABase::solve() {
     auto res = checkTrivialUnreachability();
     assert(res != VerificationAnswer::UNSAFE);
     if (res == VerificationAnswer::SAFE) { return res; }
-    unsigned short power = 0;
+    currentPower = 0;
     while (true) {
-        auto res = checkPower(power);
-        switch (res) {
-            case VerificationAnswer::UNSAFE:
-            case VerificationAnswer::SAFE:
-                return res;
-            case VerificationAnswer::UNKNOWN:
-                ++power;
+        if (cancellationToken.stopRequested()) { return VerificationAnswer::UNKNOWN; }
+        if (invariantSource) {
+            PTRef invariant = invariantSource();
+            if (invariant != logic.getTerm_true()) {
+                strengthenTransition(invariant);
+                currentPower = 0;
+            }
+        }
+        try {
+            auto res = checkPower(currentPower);
+            switch (res) {
+                case VerificationAnswer::UNSAFE:
+                case VerificationAnswer::SAFE:
+                    if (verbose() > 0) {
+                        std::cout << "; TPA: Query cache hits: " << queryCache->hits()
+                                  << ", misses: " << queryCache->misses() << ", entries: " << queryCache->size()
+                                  << std::endl;
+                    }
+                    return res;
+                case VerificationAnswer::UNKNOWN:
+                    ++currentPower;
+            }
+        } catch (std::logic_error const &) {
+            // Queries interrupted by the stop report unexpected results deep inside the reachability checks
+            if (cancellationToken.stopRequested()) { return VerificationAnswer::UNKNOWN; }
+            throw;
         }
     }
 }
 
+/*
+ * The invariant over-approximates the reachable states, so restricting the transitions to it does not change the
+ * reachability of the bad states. The abstractions of the powers are discarded, as they have been built for the weaker
+ * transition.
+ */
+void TPABase::strengthenTransition(PTRef invariant) {
+    assert(isPureStateFormula(invariant));
+    TRACE(1, "Strengthening transition with shared invariant " << logic.pp(invariant))
+    transition = logic.mkAnd({invariant, transition, getNextVersion(invariant)});
+    abstractionVersion = nextAbstractionVersion();
+    resetPowers();
+    resetExplanation();
+}
+
 VerificationAnswer TPABase::checkTrivialUnreachability() {
     if (query == logic.getTerm_false()) {
         // TODO: Check UNSAT with solver?
@@ -445,8 +902,9 @@ VerificationAnswer TPABase::checkTrivialUnreachability() {
 
 VerificationAnswer TPASplit::checkPower(unsigned short power) {
     TRACE(1, "Checking power " << power)
-    queryCache.emplace_back();
-    auto res = reachabilityQueryLessThan(init, query, power);
+    bool nextLevelBuilt = exactPowers.size() > power + 1u and lessThanPowers.size() > power + 1u;
+    auto res = cachedTopLevelQuery(TPAType::LESS_THAN, power, nextLevelBuilt,
+                                   [&]() { return reachabilityQueryLessThan(init, query, power); });
     if (isReachable(res)) {
         reachedStates = ReachedStates{res.refinedTarget, res.steps};
         return VerificationAnswer::UNSAFE;
@@ -457,7 +915,9 @@ VerificationAnswer TPASplit::checkPower(unsigned short power) {
         fixedPointReached = checkExactFixedPoint(power);
         if (fixedPointReached) { return VerificationAnswer::SAFE; }
     }
-    res = reachabilityQueryExact(init, query, power);
+    nextLevelBuilt = exactPowers.size() > power + 1u;
+    res = cachedTopLevelQuery(TPAType::EQUALS, power, nextLevelBuilt,
+                              [&]() { return reachabilityQueryExact(init, query, power); });
     if (isReachable(res)) {
         reachedStates = ReachedStates{res.refinedTarget, res.steps};
         return VerificationAnswer::UNSAFE;
@@ -478,8 +938,8 @@ VerificationAnswer TPASplit::checkPower(unsigned short power) {
 TPABase::QueryResult TPABase::reachabilityExactOneStep(PTRef from, PTRef to) {
     // TODO: this solver can be persistent and used incrementally
     QueryResult result;
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     PTRef goal = getNextVersion(to);
     PTRef smtQuery = logic.mkAnd({from, transition, goal});
     solver.insertFormula(smtQuery);
@@ -502,8 +962,8 @@ TPABase::QueryResult TPABase::reachabilityExactOneStep(PTRef from, PTRef to) {
 
 TPABase::QueryResult TPABase::reachabilityExactZeroStep(PTRef from, PTRef to) {
     QueryResult result;
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     PTRef intersection = logic.mkAnd(from, to);
     solver.insertFormula(intersection);
     auto res = solver.check();
@@ -520,6 +980,32 @@ TPABase::QueryResult TPABase::reachabilityExactZeroStep(PTRef from, PTRef to) {
     throw std::logic_error("TPA: Unexpected situation checking reachability");
 }
 
+/*
+ * Starts checking, in a helper thread, the first iteration of the exact query from 'from' to 'to' on level 'power'.
+ * The main thread uses this for the second half of a path while it is still exploring the first half.
+ */
+SpeculativeCheck TPASplit::speculateExact(PTRef from, PTRef to, unsigned short power) {
+    if (not speculativeChecks) { return {}; }
+    PTRef previousTransition = getExactPower(power);
+    PTRef twoStepTransition = logic.mkAnd(previousTransition, getNextVersion(previousTransition));
+    return speculativeChecks->submit(twoStepTransition, logic.mkAnd(from, getNextVersion(to, 2)), cancellationToken);
+}
+
+/*
+ * Collects the result of a speculative exact query on level 'power'. If the query was unreachable, the exact power of
+ * the next level is strengthened exactly as the query itself would do it.
+ */
+bool TPASplit::learnFromSpeculation(SpeculativeCheck & check, unsigned short power, bool wait) {
+    PTRef itp = check.result(wait);
+    if (itp == PTRef_Undef) { return false; }
+    itp = simplifyInterpolant(itp);
+    itp = cleanInterpolant(itp);
+    if (itp == logic.getTerm_true()) { return false; }
+    TRACE(3, "Learning from speculative query " << itp.x)
+    storeExactPower(power + 1, itp);
+    return true;
+}
+
 /*
  * Check if 'to' is reachable from 'from' (these are state formulas) in exactly 2^{n+1} steps (n is 'power').
  * We do this using the n-th abstraction of the transition relation and check 2-step reachability in this abstraction.
@@ -529,11 +1015,9 @@ TPASplit::QueryResult TPASplit::reachabilityQueryExact(PTRef from, PTRef to, uns
     //        std::cout << "Checking exact reachability on level " << power << " from " << logic.printTerm(from) << " to
     //        " << logic.printTerm(to) << std::endl;
     TRACE(2, "Checking exact reachability on level " << power << " from " << from.x << " to " << to.x)
-    assert(queryCache.size() > power);
-    auto it = queryCache[power].find({from, to});
-    if (it != queryCache[power].end()) {
+    if (auto cached = findCachedQuery(TPAType::EQUALS, power, from, to)) {
         TRACE(1, "Query found in cache on level " << power)
-        return it->second;
+        return *cached;
     }
     QueryResult result;
     PTRef goal = getNextVersion(to, 2);
@@ -558,7 +1042,7 @@ TPASplit::QueryResult TPASplit::reachabilityQueryExact(PTRef from, PTRef to, uns
                     TRACE(3, "Exact: Truly reachable states are " << result.refinedTarget.x)
                     TRACE(4, "Exact: Truly reachable states are " << logic.pp(result.refinedTarget))
                     assert(result.refinedTarget != logic.getTerm_false());
-                    queryCache[power].insert({{from, to}, result});
+                    cacheQuery(TPAType::EQUALS, power, from, to, result);
                     return result;
                 }
                 // Create the three states corresponding to current, next and next-next variables from the query
@@ -569,10 +1053,12 @@ TPASplit::QueryResult TPASplit::reachabilityQueryExact(PTRef from, PTRef to, uns
                 TRACE(3, "Midpoint from MBP: " << nextState.x)
                 // check the reachability using lower level abstraction
                 assert(power > 0);
+                auto secondHalf = speculateExact(nextState, to, power - 1);
                 auto subQueryRes = reachabilityQueryExact(from, nextState, power - 1);
                 if (isUnreachable(subQueryRes)) {
                     TRACE(3, "Exact: First half was unreachable, repeating...")
                     assert(getExactPower(power) != previousTransition);
+                    learnFromSpeculation(secondHalf, power - 1, false);
                     continue; // We need to re-check this level with refined abstraction
                 } else {
                     assert(isReachable(subQueryRes));
@@ -586,6 +1072,10 @@ TPASplit::QueryResult TPASplit::reachabilityQueryExact(PTRef from, PTRef to, uns
                 }
                 unsigned stepsToMidpoint = extractStepsTaken(subQueryRes);
                 // here the first half of the found path is feasible, check the second half
+                if (learnFromSpeculation(secondHalf, power - 1, true)) {
+                    TRACE(3, "Exact: Second half was unreachable from the whole midpoint, repeating...")
+                    continue;
+                }
                 subQueryRes = reachabilityQueryExact(nextState, to, power - 1);
                 if (isUnreachable(subQueryRes)) {
                     TRACE(3, "Exact: Second half was unreachable, repeating...")
@@ -597,7 +1087,7 @@ TPASplit::QueryResult TPASplit::reachabilityQueryExact(PTRef from, PTRef to, uns
                              << extractReachableTarget(subQueryRes).x)
                 // both halves of the found path are feasible => this path is feasible!
                 subQueryRes.steps += stepsToMidpoint;
-                queryCache[power].insert({{from, to}, subQueryRes});
+                cacheQuery(TPAType::EQUALS, power, from, to, subQueryRes);
                 return subQueryRes;
             }
             case ReachabilityResult::UNREACHABLE: {
@@ -720,10 +1210,12 @@ TPASplit::QueryResult TPASplit::reachabilityQueryLessThan(PTRef from, PTRef to,
                 TRACE(3, "Midpoint is " << nextState.x)
                 TRACE(4, "Midpoint is " << logic.pp(nextState));
                 // check the reachability using lower level abstraction
+                auto secondHalf = speculateExact(nextState, to, power - 1);
                 auto subQueryRes = reachabilityQueryLessThan(from, nextState, power - 1);
                 if (isUnreachable(subQueryRes)) {
                     TRACE(3, "Less-than: First half was unreachable, repeating...")
                     assert(getLessThanPower(power) != previousLessThanTransition);
+                    learnFromSpeculation(secondHalf, power - 1, false);
                     continue; // We need to re-check this level with refined abstraction
                 } else {
                     assert(isReachable(subQueryRes));
@@ -737,6 +1229,10 @@ TPASplit::QueryResult TPASplit::reachabilityQueryLessThan(PTRef from, PTRef to,
                 }
                 unsigned stepsToMidpoint = extractStepsTaken(subQueryRes);
                 // here the first half of the found path is feasible, check the second half
+                if (learnFromSpeculation(secondHalf, power - 1, true)) {
+                    TRACE(3, "Less-than: Second half was unreachable from the whole midpoint, repeating...")
+                    continue;
+                }
                 PTRef previousExactTransition = getExactPower(power);
                 (void)previousExactTransition;
                 subQueryRes = reachabilityQueryExact(nextState, to, power - 1);
@@ -854,6 +1350,7 @@ void TPABase::resetTransitionSystem(TransitionSystem const & system) {
         //    std::cout << "After simplifications 2: " << transition.x << std::endl;
     }
     this->identity = computeIdentity();
+    abstractionVersion = nextAbstractionVersion();
     resetPowers();
     //    std::cout << "Init: " << logic.printTerm(init) << std::endl;
     //    std::cout << "Transition: " << logic.printTerm(transition) << std::endl;
@@ -905,8 +1402,8 @@ bool TPASplit::verifyPower(unsigned short power, TPAType relationType) const {
 
 bool TPASplit::verifyLessThanPower(unsigned short power) const {
     assert(power > 0);
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     PTRef current = getLessThanPower(power);
     PTRef previous = getLessThanPower(power - 1);
     PTRef previousExact = getExactPower(power - 1);
@@ -924,8 +1421,8 @@ bool TPASplit::verifyExactPower(unsigned short power) const {
         bool previousRes = verifyExactPower(power - 1);
         if (not previousRes) { return false; }
     }
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     PTRef current = getExactPower(power);
     PTRef previous = getExactPower(power - 1);
     //    std::cout << "Exact on level " << power << " : " << logic.printTerm(current) << std::endl;
@@ -956,8 +1453,8 @@ void TPABase::houdiniCheck(PTRef invCandidates, PTRef transition, SafetyExplanat
     // LEFT:
     //   leftInvariants /\ transition /\ getNextVersion(currentLevelTransition) =>
     //     shiftOnlyNextVars(currentLevelTransition);
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.push();
     auto candidates = topLevelConjuncts(logic, invCandidates);
     if (alignment == SafetyExplanation::FixedPointType::RIGHT) {
@@ -1024,9 +1521,9 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
     for (unsigned short i = 1; i <= power; ++i) {
         PTRef currentLevelTransition = getPower(i, TPAType::LESS_THAN);
         // first check if it is a fixed point with respect to the initial states
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
         {
-            auto & solver = solverWrapper.getCoreSolver();
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
             houdiniCheck(currentLevelTransition, transition, SafetyExplanation::FixedPointType::RIGHT);
             solver.insertFormula(
                 logic.mkAnd({logic.mkAnd(rightInvariants), currentLevelTransition, getNextVersion(transition),
@@ -1060,8 +1557,8 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
         }
         // now check if it is fixed point with respect to bad states
         {
-            solverWrapper.resetSolver();
-            auto & solver = solverWrapper.getCoreSolver();
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
             houdiniCheck(currentLevelTransition, transition, SafetyExplanation::FixedPointType::LEFT);
             solver.insertFormula(logic.mkAnd({transition, getNextVersion(logic.mkAnd(leftInvariants)),
                                               getNextVersion(currentLevelTransition),
@@ -1096,8 +1593,8 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
         // TODO: Move this to a separate method?
         // now check the produced if transition invariants are actually safety invariants
         {
-            solverWrapper.resetSolver();
-            auto & solver = solverWrapper.getCoreSolver();
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
             solver.insertFormula(logic.mkAnd({init, logic.mkAnd(rightInvariants), getNextVersion(query)}));
             auto satres = solver.check();
             if (satres == s_False) {
@@ -1111,8 +1608,8 @@ bool TPABase::checkLessThanFixedPoint(unsigned short power) {
         }
         // now check the produced if transition invariants are actually safety invariants
         {
-            solverWrapper.resetSolver();
-            auto & solver = solverWrapper.getCoreSolver();
+            auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+            auto & solver = solverWrapper->getCoreSolver();
             solver.insertFormula(logic.mkAnd({init, logic.mkAnd(leftInvariants), getNextVersion(query)}));
             auto satres = solver.check();
             if (satres == s_False) {
@@ -1134,8 +1631,8 @@ bool TPASplit::checkExactFixedPoint(unsigned short power) {
         PTRef currentLevelTransition = getExactPower(i);
         PTRef currentTwoStep = logic.mkAnd(currentLevelTransition, getNextVersion(currentLevelTransition));
         PTRef shifted = shiftOnlyNextVars(currentLevelTransition);
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         solver.insertFormula(logic.mkAnd({currentTwoStep, logic.mkNot(shifted)}));
         sstat satres = solver.check();
         char restrictedInvariant = 0;
@@ -1193,8 +1690,8 @@ bool TPABase::verifyKinductiveInvariant(PTRef fla, unsigned long k) const {
 
     { // Inductive case:
 
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         for (unsigned long i = 0; i < k; ++i) {
             solver.insertFormula(getNextVersion(fla, i));
             solver.insertFormula(getNextVersion(transition, i));
@@ -1208,8 +1705,8 @@ bool TPABase::verifyKinductiveInvariant(PTRef fla, unsigned long k) const {
         TRACE(trace_level, "Inductive case succesfully verified")
     }
     { // Base cases:
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         solver.insertFormula(init);
         for (unsigned long i = 0; i < k; ++i) {
             solver.push();
@@ -1255,7 +1752,7 @@ void TPABasic::storeLevelTransition(unsigned short power, PTRef tr) {
     PTRef nextLevelTransitionStrengthening = logic.mkAnd(tr, getNextVersion(tr));
     if (not reachabilitySolvers[power + 1]) {
         reachabilitySolvers[power + 1] =
-            new SolverWrapperIncrementalWithRestarts(logic, nextLevelTransitionStrengthening);
+            new SolverWrapperIncrementalWithRestarts(logic, nextLevelTransitionStrengthening, rebuildPolicy);
         //        reachabilitySolvers[power + 1] = new SolverWrapperIncremental(logic,
         //        nextLevelTransitionStrengthening); reachabilitySolvers[power + 1] = new SolverWrapperSingleUse(logic,
         //        nextLevelTransitionStrengthening);
@@ -1271,8 +1768,9 @@ SolverWrapper * TPABasic::getReachabilitySolver(unsigned short power) const {
 
 VerificationAnswer TPABasic::checkPower(unsigned short power) {
     TRACE(1, "Checking power " << power)
-    queryCache.emplace_back();
-    auto res = reachabilityQuery(init, query, power);
+    bool nextLevelBuilt = transitionHierarchy.size() > power + 1u;
+    auto res = cachedTopLevelQuery(TPAType::LESS_THAN, power, nextLevelBuilt,
+                                   [&]() { return reachabilityQuery(init, query, power); });
     if (isReachable(res)) {
         reachedStates = ReachedStates{res.refinedTarget, res.steps};
         return VerificationAnswer::UNSAFE;
@@ -1294,11 +1792,9 @@ TPABasic::QueryResult TPABasic::reachabilityQuery(PTRef from, PTRef to, unsigned
     //        std::cout << "Checking LEQ reachability on level " << power << " from " << logic.printTerm(from) << " to "
     //        << logic.printTerm(to) << std::endl;
     TRACE(2, "Checking LEQ reachability on level " << power << " from " << from.x << " to " << to.x)
-    assert(queryCache.size() > power);
-    auto it = queryCache[power].find({from, to});
-    if (it != queryCache[power].end()) {
+    if (auto cached = findCachedQuery(TPAType::LESS_THAN, power, from, to)) {
         TRACE(1, "Query found in cache on level " << power)
-        return it->second;
+        return *cached;
     }
     QueryResult result;
     PTRef goal = getNextVersion(to, 2);
@@ -1328,7 +1824,7 @@ TPABasic::QueryResult TPABasic::reachabilityQuery(PTRef from, PTRef to, unsigned
                     //     It might be possible that the step count is not correct ?!
                     TRACE(3, "Exact: Truly reachable states are " << result.refinedTarget.x)
                     assert(result.refinedTarget != logic.getTerm_false());
-                    queryCache[power].insert({{from, to}, result});
+                    cacheQuery(TPAType::LESS_THAN, power, from, to, result);
                     return result;
                 }
                 // Create the three states corresponding to current, next and next-next variables from the query
@@ -1364,7 +1860,7 @@ TPABasic::QueryResult TPABasic::reachabilityQuery(PTRef from, PTRef to, unsigned
                              << extractReachableTarget(subQueryRes).x)
                 // both halves of the found path are feasible => this path is feasible!
                 subQueryRes.steps += stepsToMidpoint;
-                queryCache[power].insert({{from, to}, subQueryRes});
+                cacheQuery(TPAType::LESS_THAN, power, from, to, subQueryRes);
                 return subQueryRes;
             }
             case ReachabilityResult::UNREACHABLE: {
@@ -1399,8 +1895,8 @@ bool TPABasic::verifyPower(unsigned short power, TPAType relationType) const {
 
 bool TPABasic::verifyPower(unsigned short level) const {
     assert(level > 0);
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    auto & solver = solverWrapper->getCoreSolver();
     PTRef current = getLevelTransition(level);
     PTRef previous = getLevelTransition(level - 1);
     solver.insertFormula(logic.mkAnd(previous, getNextVersion(previous)));
@@ -1431,21 +1927,58 @@ PTRef TPABase::safeSupersetOfInitialStates(PTRef start, PTRef transitionInvarian
  * Extension for DAG of transition systems
  */
 
+/*
+ * Depth-first search for a path through the DAG of transition systems.
+ *
+ * With more than one network thread, the systems of the siblings of the node the search descends to are solved
+ * speculatively in other threads. A speculative answer is used when the search reaches the sibling with the same
+ * initial states (edge queries are remembered, so the same query propagates the same states) and the query states of
+ * the sibling have not changed in the meantime. All the bookkeeping of the search (trulySafe,
+ * trulyReached and accumulatedRestrictions) stays in the main thread; the helper threads only run the node solvers.
+ */
 class TransitionSystemNetworkManager {
     TPAEngine & owner;
     Logic & logic;
     ChcDirectedGraph const & graph;
     AdjacencyListsGraphRepresentation adjacencyRepresentation;
+    std::size_t speculativeThreads = 0;
 
 public:
     TransitionSystemNetworkManager(TPAEngine & owner, ChcDirectedGraph const & graph)
         : owner(owner), logic(owner.logic), graph(graph),
-          adjacencyRepresentation(AdjacencyListsGraphRepresentation::from(graph)) {}
+          adjacencyRepresentation(AdjacencyListsGraphRepresentation::from(graph)) {
+        auto threads = std::stoul(owner.options.getOrDefault(Options::TPA_NETWORK_THREADS, "1"));
+        if (dynamic_cast<ArithLogic *>(&logic) and threads > 1) { speculativeThreads = threads - 1; }
+    }
+
+    ~TransitionSystemNetworkManager();
 
     VerificationResult solve() &&;
 
 private:
+    // The term store is not thread-safe, so a node solved in other threads works in its own logic. The terms are
+    // translated only by the main thread, while the node is not being solved.
+    struct NodeLogic {
+        ArithLogic logic;
+        TermTranslator toNode;
+        TermTranslator fromNode;
+
+        explicit NodeLogic(ArithLogic & network)
+            : logic(network.hasIntegers() ? opensmt::Logic_t::QF_LIA : opensmt::Logic_t::QF_LRA),
+              toNode(network, logic), fromNode(logic, network) {}
+    };
+
+    // Solving of a node started before the search reached it
+    struct Speculation {
+        EId edge;
+        PTRef initialStates; // The states propagated along the edge
+        CancellationToken token;
+        std::future<VerificationAnswer> pending;
+        std::optional<VerificationAnswer> answer;
+    };
+
     struct NetworkNode {
+        std::unique_ptr<NodeLogic> ownLogic{nullptr}; // Only with speculative threads
         std::unique_ptr<TPABase> solver{nullptr};
         PTRef trulyReached{PTRef_Undef};
         PTRef trulySafe{PTRef_Undef};
@@ -1453,17 +1986,48 @@ private:
         vec<EId> children;
         int blocked_children;
         vec<EId> parents;
+        std::optional<Speculation> speculation;
     };
 
     vec<EId> activePath;
 
     std::unordered_map<SymRef, NetworkNode, SymRefHash> networkMap;
 
+    struct EdgeSolver {
+        static constexpr std::size_t labelPartition = 0;
+        SMTSolver solver;
+        std::size_t insertedFormulas = 0; // Interpolation partitions also count the formulas of popped frames
+
+        EdgeSolver(Logic & logic, PTRef label);
+        std::size_t insert(PTRef fla);
+    };
+
+    struct EdgeQuery {
+        std::size_t edge;
+        PTRef source;
+        PTRef target;
+
+        bool operator==(EdgeQuery const & other) const {
+            return edge == other.edge and source == other.source and target == other.target;
+        }
+    };
+
+    struct EdgeQueryHash {
+        std::size_t operator()(EdgeQuery const & query) const {
+            return std::hash<std::size_t>{}(query.edge) ^ (PTRefHash{}(query.source) << 1) ^
+                   (PTRefHash{}(query.target) << 2);
+        }
+    };
+
+    std::unordered_map<std::size_t, std::unique_ptr<EdgeSolver>> edgeSolvers;
+
     struct QueryResult {
         ReachabilityResult reachabilityResult;
         PTRef explanation;
     };
 
+    std::unordered_map<EdgeQuery, QueryResult, EdgeQueryHash> edgeQueries;
+
     bool reachable(ReachabilityResult res) { return res == ReachabilityResult::REACHABLE; }
 
     void initNetwork();
@@ -1499,13 +2063,31 @@ private:
 
     const vec<EId> & getOutgoingEdges(SymRef vid) const { return getNode(vid).children; }
 
-    PTRef getInitialStates(SymRef vid) const { return networkMap.at(vid).solver->getInit(); }
+    PTRef toNode(NetworkNode & node, PTRef fla) const {
+        return node.ownLogic ? node.ownLogic->toNode.translate(fla) : fla;
+    }
+
+    PTRef fromNode(NetworkNode & node, PTRef fla) const {
+        return node.ownLogic ? node.ownLogic->fromNode.translate(fla) : fla;
+    }
 
-    PTRef getQueryStates(SymRef vid) const { return networkMap.at(vid).solver->getQuery(); }
+    TransitionSystem toNode(NetworkNode & node, TransitionSystem const & system) const;
+
+    void setInitialStates(SymRef vid, PTRef fla);
 
     QueryResult queryEdge(EId eid, PTRef sourceCondition, PTRef targetCondition);
 
-    QueryResult queryTransitionSystem(NetworkNode & node);
+    std::optional<QueryResult> queryTransitionSystem(NetworkNode & node);
+
+    void speculateSiblings(SymRef vid, PTRef reached, SymRef next);
+
+    VerificationAnswer awaitSpeculation(NetworkNode & node);
+
+    void dropSpeculation(SymRef vid);
+
+    void resetTransitionSystem(SymRef vid);
+
+    VerificationResult interrupted() const;
 
     InvalidityWitness computeInvalidityWitness() const;
 
@@ -1521,8 +2103,125 @@ void TransitionSystemNetworkManager::addRestrictions(SymRef node, PTRef fla) {
 }
 
 void TransitionSystemNetworkManager::updateRestrictions(SymRef node) {
-    getNode(node).solver->updateQueryStates(getNode(node).accumulatedRestrictions);
-    getNode(node).accumulatedRestrictions = logic.getTerm_false();
+    auto & networkNode = getNode(node);
+    dropSpeculation(node);
+    networkNode.solver->updateQueryStates(toNode(networkNode, networkNode.accumulatedRestrictions));
+    networkNode.accumulatedRestrictions = logic.getTerm_false();
+}
+
+TransitionSystemNetworkManager::~TransitionSystemNetworkManager() {
+    for (auto & [vid, node] : networkMap) {
+        if (node.speculation and node.speculation->pending.valid()) {
+            node.speculation->token.requestStop();
+            try {
+                node.speculation->pending.get();
+            } catch (...) {} // Nobody is interested in the result anymore
+        }
+    }
+}
+
+void TransitionSystemNetworkManager::setInitialStates(SymRef vid, PTRef fla) {
+    auto & node = getNode(vid);
+    if (node.speculation and node.speculation->initialStates == fla) { return; } // Already being solved from these
+    dropSpeculation(vid);
+    node.solver->resetInitialStates(toNode(node, fla));
+}
+
+VerificationAnswer TransitionSystemNetworkManager::awaitSpeculation(NetworkNode & node) {
+    assert(node.speculation);
+    auto & speculation = *node.speculation;
+    if (not speculation.answer) {
+        // The solver reads its token while it runs; the token of the speculation is a child of the engine's token, so
+        // stopping the engine stops the speculation as well
+        speculation.answer = speculation.pending.get();
+        node.solver->setCancellationToken(owner.cancellationToken);
+    }
+    return speculation.answer.value();
+}
+
+/*
+ * A speculation that is no longer needed is stopped, as it may run for a long time on states the search does not care
+ * about. The solver must not be touched before it returns. If it was stopped in the middle of a run, its abstractions
+ * may be incomplete, so the solver is rebuilt with the same initial and query states.
+ */
+void TransitionSystemNetworkManager::dropSpeculation(SymRef vid) {
+    auto & node = getNode(vid);
+    if (not node.speculation) { return; }
+    auto & speculation = *node.speculation;
+    bool finished = speculation.answer or
+                    speculation.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (not finished) { speculation.token.requestStop(); }
+    awaitSpeculation(node);
+    node.speculation.reset();
+    if (not finished) {
+        PTRef init = node.solver->getInit();
+        PTRef query = node.solver->getQuery();
+        resetTransitionSystem(vid);
+        node.solver->resetInitialStates(init);
+        node.solver->updateQueryStates(query);
+    }
+}
+
+void TransitionSystemNetworkManager::resetTransitionSystem(SymRef vid) {
+    auto & node = getNode(vid);
+    TransitionSystem ts = constructTransitionSystemFor(vid);
+    if (node.ownLogic) {
+        node.solver->resetTransitionSystem(toNode(node, ts));
+    } else {
+        node.solver->resetTransitionSystem(ts);
+    }
+}
+
+/*
+ * Starts solving the targets of the remaining outgoing edges of the node, other than the node the search descends to,
+ * as long as there are free threads. The edges are queried by the main thread, with the same conditions that the search
+ * would use when it returns to this node.
+ */
+void TransitionSystemNetworkManager::speculateSiblings(SymRef vid, PTRef reached, SymRef next) {
+    if (speculativeThreads == 0) { return; }
+    auto running = [&]() {
+        return std::count_if(networkMap.begin(), networkMap.end(), [](auto const & entry) {
+            auto const & speculation = entry.second.speculation;
+            return speculation and not speculation->answer and
+                   speculation->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+        });
+    };
+    auto const & children = getOutgoingEdges(vid);
+    for (int i = getNode(vid).blocked_children; i < children.size(); ++i) {
+        if (static_cast<std::size_t>(running()) >= speculativeThreads) { return; }
+        EId edge = children[i];
+        auto target = graph.getTarget(edge);
+        if (target == graph.getExit() or target == next or getNode(target).speculation) { continue; }
+        PTRef targetCondition = logic.mkNot(getNode(target).trulySafe);
+        auto [edgeRes, edgeExplanation] = queryEdge(edge, reached, targetCondition);
+        if (not reachable(edgeRes)) { continue; }
+        auto & node = getNode(target);
+        node.solver->resetInitialStates(toNode(node, edgeExplanation));
+        auto token = owner.cancellationToken.createChild();
+        node.solver->setCancellationToken(token);
+        TRACE(1, "Speculatively solving the target of edge " << edge.id)
+        auto pending = std::async(std::launch::async, [solver = node.solver.get(), token]() {
+            CancellationToken::Scope scope(token);
+            return solver->solve();
+        });
+        node.speculation = Speculation{edge, edgeExplanation, token, std::move(pending), {}};
+    }
+}
+
+TransitionSystem TransitionSystemNetworkManager::toNode(NetworkNode & node, TransitionSystem const & system) const {
+    assert(node.ownLogic);
+    auto & translator = node.ownLogic->toNode;
+    vec<PTRef> stateVars;
+    vec<PTRef> auxiliaryVars;
+    for (PTRef var : system.getStateVars()) {
+        stateVars.push(translator.translate(var));
+    }
+    for (PTRef var : system.getAuxiliaryVars()) {
+        auxiliaryVars.push(translator.translate(var));
+    }
+    auto systemType = std::make_unique<SystemType>(stateVars, auxiliaryVars, node.ownLogic->logic);
+    return TransitionSystem(node.ownLogic->logic, std::move(systemType), translator.translate(system.getInit()),
+                            translator.translate(system.getTransition()), translator.translate(system.getQuery()));
 }
 
 VerificationResult TPAEngine::solveTransitionSystemGraph(const ChcDirectedGraph & graph) {
@@ -1538,20 +2237,24 @@ void TransitionSystemNetworkManager::initNetwork() {
         }
         networkMap.insert({vid, NetworkNode()});
         auto & node = networkMap.at(vid);
-        node.solver = mkSolver();
         node.blocked_children = 0;
-        TransitionSystem ts = constructTransitionSystemFor(vid);
-        node.solver->resetTransitionSystem(ts);
+        if (speculativeThreads > 0) {
+            node.ownLogic = std::make_unique<NodeLogic>(dynamic_cast<ArithLogic &>(logic));
+            node.solver = owner.mkSolver(node.ownLogic->logic);
+        } else {
+            node.solver = mkSolver();
+        }
+        resetTransitionSystem(vid);
         node.trulySafe = logic.getTerm_false();
     }
     TimeMachine tm(logic);
     for (EId eid : adjacencyRepresentation.getOutgoingEdgesFor(graph.getEntry())) {
         auto target = graph.getTarget(eid);
-        getNode(target).solver->resetInitialStates(logic.getTerm_true());
+        setInitialStates(target, logic.getTerm_true());
     }
     for (EId eid : adjacencyRepresentation.getIncomingEdgesFor(graph.getExit())) {
-        auto source = graph.getSource(eid);
-        networkMap.at(source).solver->updateQueryStates(logic.getTerm_true());
+        auto & source = getNode(graph.getSource(eid));
+        source.solver->updateQueryStates(toNode(source, logic.getTerm_true()));
     }
     // Connect the network
     for (auto vid : reversePostOrder(graph, adjacencyRepresentation)) {
@@ -1583,6 +2286,7 @@ VerificationResult TransitionSystemNetworkManager::solve() && {
     auto current = graph.getEntry();
     activePath.clear();
     while (true) {
+        if (owner.cancellationToken.stopRequested()) { return interrupted(); }
         if (getNode(current).blocked_children == getNode(current).children.size()) {
             if (current == graph.getEntry()) {
                 witness_t witness = owner.shouldComputeWitness() ? computeValidityWitness() : NoWitness{};
@@ -1607,7 +2311,8 @@ VerificationResult TransitionSystemNetworkManager::solve() && {
                         return {VerificationAnswer::UNSAFE, computeInvalidityWitness()};
                     }
                     auto next = graph.getTarget(nextEdge);
-                    networkMap.at(next).solver->resetInitialStates(edgeExplanation);
+                    setInitialStates(next, edgeExplanation);
+                    speculateSiblings(current, logic.getTerm_true(), next);
                     activePath.push(nextEdge);
                     current = next;
                     break; // Information has been propagated to the next node, switch to the new node
@@ -1619,7 +2324,9 @@ VerificationResult TransitionSystemNetworkManager::solve() && {
             }
             continue;
         }
-        auto [res, explanation] = queryTransitionSystem(networkMap.at(current));
+        auto queryResult = queryTransitionSystem(networkMap.at(current));
+        if (not queryResult.has_value()) { return interrupted(); }
+        auto [res, explanation] = queryResult.value();
         if (reachable(res)) {
             getNode(current).trulyReached = explanation;
             while (getNode(current).blocked_children < getNode(current).children.size()) {
@@ -1635,7 +2342,8 @@ VerificationResult TransitionSystemNetworkManager::solve() && {
                         return {VerificationAnswer::UNSAFE, computeInvalidityWitness()};
                     }
                     auto next = graph.getTarget(nextEdge);
-                    networkMap.at(next).solver->resetInitialStates(edgeExplanation);
+                    setInitialStates(next, edgeExplanation);
+                    speculateSiblings(current, explanation, next);
                     activePath.push(nextEdge);
                     current = next;
                     break; // Information has been propagated to the next node, switch to the new node
@@ -1654,7 +2362,7 @@ VerificationResult TransitionSystemNetworkManager::solve() && {
             PTRef updatedConditions = logic.mkNot(getNode(current).trulySafe);
             auto [edgeRes, edgeExplanation] = queryEdge(previousEdge, previousNode.trulyReached, updatedConditions);
             if (reachable(edgeRes)) { // New reached, not refuted yet, states
-                getNode(current).solver->resetInitialStates(edgeExplanation);
+                setInitialStates(current, edgeExplanation);
                 continue; // Repeat the query for the same TS with new initial states
             } else {      // Cannot continue from currently computed truly reached states
                 previousNode.trulyReached = PTRef_Undef;
@@ -1700,18 +2408,20 @@ witness_t TransitionSystemNetworkManager::computeValidityWitness() {
 
         auto graphVars = utils.predicateArgsInOrder(graph.getStateVersion(vertex));
         vec<PTRef> unversionedVars;
-        auto systemVars = networkMap.at(vertex).solver->getStateVars(0);
+        auto & node = getNode(vertex);
+        dropSpeculation(vertex);
+        auto systemVars = node.solver->getStateVars(0);
 
         for (std::size_t i = 0; i < graphVars.size(); ++i) {
             unversionedVars.push(timeMachine.getUnversioned(graphVars[i]));
-            subs.insert({systemVars[i], unversionedVars.last()});
+            subs.insert({fromNode(node, systemVars[i]), unversionedVars.last()});
         }
-        getNode(vertex).solver->resetInitialStates(getNode(vertex).trulySafe);
+        setInitialStates(vertex, node.trulySafe);
         // It uses the query which was set during solving of DAG
-        auto [res, explanation] = queryTransitionSystem(networkMap.at(vertex));
-        assert(res == ReachabilityResult::UNREACHABLE);
-        if (res == ReachabilityResult::UNREACHABLE) {
-            PTRef graphInvariant = utils.varSubstitute(getNode(vertex).solver->getInductiveInvariant(), subs);
+        auto queryResult = queryTransitionSystem(node);
+        assert(queryResult.has_value() and queryResult->reachabilityResult == ReachabilityResult::UNREACHABLE);
+        if (queryResult.has_value() and queryResult->reachabilityResult == ReachabilityResult::UNREACHABLE) {
+            PTRef graphInvariant = utils.varSubstitute(fromNode(node, node.solver->getInductiveInvariant()), subs);
             PTRef unversionedPredicate = logic.mkUninterpFun(vertex, std::move(unversionedVars));
             definitions[unversionedPredicate] = graphInvariant;
         } else {
@@ -1721,6 +2431,11 @@ witness_t TransitionSystemNetworkManager::computeValidityWitness() {
     return ValidityWitness(std::move(definitions));
 }
 
+VerificationResult TransitionSystemNetworkManager::interrupted() const {
+    return interruptedResult(owner.cancellationToken, "TPA: Stopped while exploring a path with " +
+                                                          std::to_string(activePath.size()) + " edges in the network");
+}
+
 TransitionSystem TransitionSystemNetworkManager::constructTransitionSystemFor(SymRef vid) const {
     EId loopEdge = getSelfLoopFor(vid, graph, adjacencyRepresentation).value();
     auto edgeVars = getVariablesFromEdge(logic, graph, loopEdge);
@@ -1730,59 +2445,97 @@ TransitionSystem TransitionSystemNetworkManager::constructTransitionSystemFor(Sy
     return TransitionSystem(logic, std::move(systemType), logic.getTerm_true(), transitionFla, logic.getTerm_true());
 }
 
+TransitionSystemNetworkManager::EdgeSolver::EdgeSolver(Logic & logic, PTRef label)
+    : solver(logic, SMTSolver::WitnessProduction::MODEL_AND_INTERPOLANTS) {
+    solver.getConfig().setLRAInterpolationAlgorithm(itp_lra_alg_decomposing_strong);
+    solver.getConfig().setSimplifyInterpolant(4);
+    insert(label);
+}
+
+std::size_t TransitionSystemNetworkManager::EdgeSolver::insert(PTRef fla) {
+    solver.getCoreSolver().insertFormula(fla);
+    return insertedFormulas++;
+}
+
+/*
+ * The label of each edge is asserted once in a solver kept for the edge; the conditions of a query are asserted in a
+ * frame that is popped afterwards. The results are remembered, because the search repeats the same queries when it
+ * returns to a node.
+ */
 TransitionSystemNetworkManager::QueryResult TransitionSystemNetworkManager::queryEdge(EId eid, PTRef sourceCondition,
                                                                                       PTRef targetCondition) {
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::MODEL_AND_INTERPOLANTS);
-    auto & solver = solverWrapper.getCoreSolver();
-    solverWrapper.getConfig().setLRAInterpolationAlgorithm(itp_lra_alg_decomposing_strong);
-    solverWrapper.getConfig().setSimplifyInterpolant(4);
+    EdgeQuery edgeQuery{eid.id, sourceCondition, targetCondition};
+    if (auto it = edgeQueries.find(edgeQuery); it != edgeQueries.end()) {
+        TRACE(1, "Edge query " << eid.id << " answered from previous queries")
+        return it->second;
+    }
     PTRef label = graph.getEdgeLabel(eid);
+    auto & edgeSolver = edgeSolvers[eid.id];
+    if (not edgeSolver) { edgeSolver = std::make_unique<EdgeSolver>(logic, label); }
+    auto & solver = edgeSolver->solver.getCoreSolver();
     TRACE(1, "Querying edge " << eid.id << " with label " << logic.pp(label) << "\n\tsource is "
                               << logic.pp(sourceCondition) << "\n\ttarget is " << logic.pp(targetCondition))
     PTRef target = TimeMachine(logic).sendFlaThroughTime(targetCondition, 1);
-    solver.insertFormula(sourceCondition);
-    solver.insertFormula(label);
-    solver.insertFormula(target);
+    solver.push();
+    edgeSolver->insert(sourceCondition);
+    auto targetPartition = edgeSolver->insert(target);
     auto res = solver.check();
-    if (res == s_True) {
-        auto model = solver.getModel();
-        ModelBasedProjection mbp(logic);
-        PTRef query = logic.mkAnd({sourceCondition, label, target});
-        auto targetVars = TermUtils(logic).predicateArgsInOrder(graph.getNextStateVersion(graph.getTarget(eid)));
-        PTRef eliminated = mbp.keepOnly(query, targetVars, *model);
-        eliminated = TimeMachine(logic).sendFlaThroughTime(eliminated, -1);
-        TRACE(1, "Propagating along the edge " << logic.pp(eliminated))
-        return {ReachabilityResult::REACHABLE, eliminated};
-    } else if (res == s_False) {
-        auto itpContext = solver.getInterpolationContext();
-        ipartitions_t mask = (1 << 1) + (1 << 2); // This puts label + target into the A-part
+    auto result = [&]() -> QueryResult {
+        if (res == s_True) {
+            auto model = solver.getModel();
+            ModelBasedProjection mbp(logic);
+            PTRef query = logic.mkAnd({sourceCondition, label, target});
+            auto targetVars = TermUtils(logic).predicateArgsInOrder(graph.getNextStateVersion(graph.getTarget(eid)));
+            PTRef eliminated = mbp.keepOnly(query, targetVars, *model);
+            eliminated = TimeMachine(logic).sendFlaThroughTime(eliminated, -1);
+            TRACE(1, "Propagating along the edge " << logic.pp(eliminated))
+            return {ReachabilityResult::REACHABLE, eliminated};
+        } else if (res == s_False) {
+            auto itpContext = solver.getInterpolationContext();
+            ipartitions_t mask = 0; // This puts label + target into the A-part
+            opensmt::setbit(mask, EdgeSolver::labelPartition);
+            opensmt::setbit(mask, targetPartition);
 
-        vec<PTRef> itps;
-        itpContext->getSingleInterpolant(itps, mask);
-        assert(itps.size() == 1);
-        PTRef explanation = logic.mkNot(itps[0]);
-        TRACE(1, "Blocking edge with " << logic.pp(explanation))
-        return {ReachabilityResult::UNREACHABLE, explanation};
+            vec<PTRef> itps;
+            itpContext->getSingleInterpolant(itps, mask);
+            assert(itps.size() == 1);
+            PTRef explanation = logic.mkNot(itps[0]);
+            TRACE(1, "Blocking edge with " << logic.pp(explanation))
+            return {ReachabilityResult::UNREACHABLE, explanation};
+        }
+        throw std::logic_error("Error in the underlying SMT solver");
+    }();
+    solver.pop();
+    edgeQueries.emplace(edgeQuery, result);
+    return result;
+}
+
+std::optional<TransitionSystemNetworkManager::QueryResult>
+TransitionSystemNetworkManager::queryTransitionSystem(NetworkNode & node) {
+    VerificationAnswer res;
+    if (node.speculation) {
+        TRACE(1, "Using the speculative answer for the target of edge " << node.speculation->edge.id)
+        res = awaitSpeculation(node);
+        node.speculation.reset();
+    } else {
+        res = node.solver->solve();
     }
-    throw std::logic_error("Error in the underlying SMT solver");
-}
-
-TransitionSystemNetworkManager::QueryResult TransitionSystemNetworkManager::queryTransitionSystem(NetworkNode & node) {
-    auto res = node.solver->solve();
-    assert(res != VerificationAnswer::UNKNOWN);
     switch (res) {
         case VerificationAnswer::UNSAFE: {
-            PTRef explanation = node.solver->getReachedStates();
+            PTRef explanation = fromNode(node, node.solver->getReachedStates());
             assert(explanation != PTRef_Undef);
             TRACE(1, "TS propagates reachable states to " << logic.pp(explanation))
-            return {ReachabilityResult::REACHABLE, explanation};
+            return QueryResult{ReachabilityResult::REACHABLE, explanation};
         }
         case VerificationAnswer::SAFE: {
-            PTRef explanation = node.solver->getSafetyExplanation();
+            PTRef explanation = fromNode(node, node.solver->getSafetyExplanation());
             assert(explanation != PTRef_Undef);
             TRACE(1, "TS blocks " << logic.pp(explanation))
-            return {ReachabilityResult::UNREACHABLE, explanation};
+            return QueryResult{ReachabilityResult::UNREACHABLE, explanation};
         }
+        case VerificationAnswer::UNKNOWN:
+            // The underlying solver gave up, e.g., because it has been cancelled
+            return std::nullopt;
         default:
             assert(false);
             throw std::logic_error("Unreachable");
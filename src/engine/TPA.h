@@ -11,6 +11,10 @@
 
 #include "osmt_solver.h"
 
+#include <functional>
+#include <list>
+#include <optional>
+
 class TransitionSystem;
 
 enum class ReachabilityResult { REACHABLE, UNREACHABLE };
@@ -27,7 +31,23 @@ public:
     virtual PTRef lastQueryTransitionInterpolant() = 0;
 };
 
+/**
+ * Decides when an incremental reachability solver is rebuilt with all strengthenings of the transition consolidated.
+ * The fixed policy rebuilds after a given number of levels (checks and strengthenings), the adaptive policy decides
+ * based on the size of the push frames and on the time of the recent checks.
+ */
+struct RebuildPolicy {
+    enum class Kind : char { ADAPTIVE, FIXED, NEVER };
+    Kind kind{Kind::ADAPTIVE};
+    unsigned long levelLimit{100};
+
+    static RebuildPolicy fromOptions(Options const & options);
+};
+
 class TPABase;
+class TPAQueryCache;
+class SpeculativeCheck;
+class SpeculativeChecks;
 
 enum class TPACore { BASIC, SPLIT };
 
@@ -35,6 +55,7 @@ class TPAEngine : public Engine {
     Logic & logic;
     Options options;
     TPACore coreAlgorithm;
+    std::shared_ptr<TPAQueryCache> queryCache; // Shared by all solvers of this engine, created with the first one
     friend class TransitionSystemNetworkManager;
 
 public:
@@ -52,9 +73,16 @@ private:
     VerificationResult solve(const ChcDirectedGraph & system);
 
     std::unique_ptr<TPABase> mkSolver();
+    /** Solver working in the given logic; other than the engine's logic only for solvers running in other threads */
+    std::unique_ptr<TPABase> mkSolver(Logic & solverLogic);
 
     VerificationResult solveTransitionSystemGraph(ChcDirectedGraph const & graph);
 
+    VerificationResult interrupted(TPABase const & solver) const;
+
+    std::function<PTRef()> sharedInvariantSource(ChcDirectedGraph const & graph, TransitionSystem const & system,
+                                                 PTRef & acceptedInvariant) const;
+
     ValidityWitness computeValidityWitness(ChcDirectedGraph const & graph, TransitionSystem const & ts,
                                            PTRef inductiveInvariant) const;
 
@@ -63,6 +91,99 @@ private:
 
 enum class TPAType : char { LESS_THAN, EQUALS };
 
+struct TPAQueryResult {
+    ReachabilityResult result;
+    PTRef refinedTarget{PTRef_Undef};
+    unsigned steps{0};
+};
+
+/**
+ * Results of reachability queries between two sets of states in a given number of steps of a transition relation.
+ *
+ * Reachable results are facts about the concrete transition relation, so they stay valid when the initial or query
+ * states of the system change, and they can be shared by all solvers working with the same transition.
+ * An unreachable result is only reused by the solver that produced it, while it keeps the same abstraction: the solver
+ * relies on the query having strengthened its abstraction. Such a result also answers queries whose source and target
+ * states are stronger (have more top-level conjuncts).
+ * The cache is bounded by the number of entries and evicts the least recently used ones.
+ */
+class TPAQueryCache {
+public:
+    struct Key {
+        PTRef transition;
+        TPAType type; // Basic TPA uses LESS_THAN for its less-or-equal queries; one engine never runs both cores
+        unsigned short power;
+        PTRef from;
+        PTRef to;
+
+        bool operator==(Key const & other) const {
+            return transition == other.transition and type == other.type and power == other.power and
+                   from == other.from and to == other.to;
+        }
+    };
+
+    /** The solver that computed a result, and the version of its abstraction at that time */
+    struct Producer {
+        void const * solver{nullptr};
+        std::size_t abstraction{0};
+
+        bool operator==(Producer const & other) const {
+            return solver == other.solver and abstraction == other.abstraction;
+        }
+    };
+
+    TPAQueryCache(Logic & logic, std::size_t capacity) : logic(logic), capacity(capacity) {}
+
+    static std::shared_ptr<TPAQueryCache> fromOptions(Logic & logic, Options const & options);
+
+    /** Result of exactly this query, if it is known */
+    std::optional<TPAQueryResult> find(Key const & key);
+
+    /**
+     * Whether this query, or a query with weaker source and target states, is known to be unreachable from a result of
+     * the given producer
+     */
+    bool knownUnreachable(Key const & key, Producer const & producer);
+
+    void insert(Key const & key, TPAQueryResult result, Producer const & producer);
+
+    [[nodiscard]] std::size_t hits() const { return hitCount; }
+    [[nodiscard]] std::size_t misses() const { return missCount; }
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(Key const & key) const {
+            return PTRefHash{}(key.transition) ^ (PTRefHash{}(key.from) << 1) ^ (PTRefHash{}(key.to) << 2) ^
+                   (static_cast<std::size_t>(key.power) << 3) ^ static_cast<std::size_t>(key.type);
+        }
+    };
+    struct Entry {
+        Key key;
+        TPAQueryResult result;
+        Producer producer;
+    };
+
+    static Key levelOf(Key key) {
+        key.from = PTRef_Undef;
+        key.to = PTRef_Undef;
+        return key;
+    }
+
+    bool subsumes(Key const & weaker, Key const & stronger) const;
+    void touch(std::list<Entry>::iterator it) { entries.splice(entries.begin(), entries, it); }
+    void forgetUnreachable(Key const & key);
+    void evict();
+
+    Logic & logic;
+    std::size_t capacity;
+    std::list<Entry> entries; // The most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::unordered_map<Key, std::vector<Key>, KeyHash> unreachableOnLevel;
+    std::size_t hitCount = 0;
+    std::size_t missCount = 0;
+};
+
 struct SafetyExplanation {
     enum class TransitionInvariantType : char { NONE, UNRESTRICTED, RESTRICTED_TO_INIT, RESTRICTED_TO_QUERY };
 
@@ -88,6 +209,7 @@ protected:
     Options const & options;
     int verbosity = 0;
     bool useQE = false;
+    RebuildPolicy rebuildPolicy;
     SafetyExplanation explanation;
     ReachedStates reachedStates;
 
@@ -102,14 +224,31 @@ protected:
 
     PTRef identity{PTRef_Undef};
 
+    CancellationToken cancellationToken;
+    std::function<PTRef()> invariantSource;
+    unsigned short currentPower{0};
+    std::size_t abstractionVersion{0}; // Changes whenever the abstractions of the powers are discarded, never reused
+
 public:
     TPABase(Logic & logic, Options const & options) : logic(logic), options(options) {
         verbosity = std::stoi(options.getOrDefault(Options::VERBOSE, "0"));
         if (options.hasOption(Options::TPA_USE_QE)) { useQE = true; }
+        rebuildPolicy = RebuildPolicy::fromOptions(options);
+        queryCache = TPAQueryCache::fromOptions(logic, options);
     }
 
     virtual ~TPABase() = default;
 
+    void setCancellationToken(CancellationToken token) { cancellationToken = std::move(token); }
+
+    void setQueryCache(std::shared_ptr<TPAQueryCache> cache) { queryCache = std::move(cache); }
+
+    /**
+     * The source is consulted before each power is checked. It returns invariants of the system proven elsewhere (true
+     * if there are none); the transition is restricted to them and the search starts again from power 0.
+     */
+    void setInvariantSource(std::function<PTRef()> source) { invariantSource = std::move(source); }
+
     virtual VerificationAnswer solveTransitionSystem(TransitionSystem & system);
 
     void resetTransitionSystem(TransitionSystem const & system);
@@ -132,6 +271,8 @@ public:
     PTRef getSafetyExplanation() const;
     PTRef getReachedStates() const;
     unsigned getTransitionStepCount() const;
+    /** The power being checked when the solver stopped; only meaningful for an UNKNOWN answer */
+    unsigned short getCurrentPower() const { return currentPower; }
     PTRef getInductiveInvariant() const;
     vec<PTRef> getStateVars(int version) const;
 
@@ -140,22 +281,24 @@ protected:
 
     virtual void resetPowers() = 0;
 
+    void strengthenTransition(PTRef invariant);
+
     virtual PTRef getPower(unsigned short power, TPAType relationType) const = 0;
     virtual bool verifyPower(unsigned short power, TPAType relationType) const = 0;
 
-    struct QueryResult {
-        ReachabilityResult result;
-        PTRef refinedTarget{PTRef_Undef};
-        unsigned steps{0};
-    };
+    using QueryResult = TPAQueryResult;
 
     static bool isReachable(QueryResult res) { return res.result == ReachabilityResult::REACHABLE; };
     static bool isUnreachable(QueryResult res) { return res.result == ReachabilityResult::UNREACHABLE; };
     static PTRef extractReachableTarget(QueryResult res) { return res.refinedTarget; };
     static unsigned extractStepsTaken(QueryResult res) { return res.steps; };
 
-    using CacheType = std::unordered_map<std::pair<PTRef, PTRef>, QueryResult, PTRefPairHash>;
-    std::vector<CacheType> queryCache;
+    std::shared_ptr<TPAQueryCache> queryCache;
+
+    std::optional<QueryResult> findCachedQuery(TPAType type, unsigned short power, PTRef from, PTRef to) const;
+    void cacheQuery(TPAType type, unsigned short power, PTRef from, PTRef to, QueryResult result) const;
+    QueryResult cachedTopLevelQuery(TPAType type, unsigned short power, bool nextLevelBuilt,
+                                    std::function<QueryResult()> const & runQuery);
 
     struct VersionHasher {
         std::size_t operator()(std::pair<PTRef, int> val) const {
@@ -163,6 +306,7 @@ protected:
         }
     };
     mutable std::unordered_map<std::pair<PTRef, int>, PTRef, VersionHasher> versioningCache;
+    mutable TimeMachine timeMachine{logic};
 
     PTRef getNextVersion(PTRef currentVersion, int) const;
     PTRef getNextVersion(PTRef currentVersion) const { return getNextVersion(currentVersion, 1); };
@@ -214,8 +358,10 @@ class TPASplit : public TPABase {
 
     vec<SolverWrapper *> reachabilitySolvers;
 
+    std::unique_ptr<SpeculativeChecks> speculativeChecks; // Only with more than one thread
+
 public:
-    TPASplit(Logic & logic, Options const & options) : TPABase(logic, options) {}
+    TPASplit(Logic & logic, Options const & options);
 
     ~TPASplit() override;
 
@@ -239,6 +385,9 @@ private:
     QueryResult reachabilityQueryExact(PTRef from, PTRef to, unsigned short power);
     QueryResult reachabilityQueryLessThan(PTRef from, PTRef to, unsigned short power);
 
+    SpeculativeCheck speculateExact(PTRef from, PTRef to, unsigned short power);
+    bool learnFromSpeculation(SpeculativeCheck & check, unsigned short power, bool wait);
+
     bool verifyLessThanPower(unsigned short power) const;
     bool verifyExactPower(unsigned short power) const;
 
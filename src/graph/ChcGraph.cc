@@ -6,6 +6,7 @@
 
 #include "ChcGraph.h"
 
+#include <atomic>
 #include <iostream>
 #include <map>
 
@@ -355,7 +356,7 @@ PTRef renameAuxiliaries(ChcDirectedHyperGraph const & graph, EId incoming) {
     PTRef incomingLabel = graph.getEdgeLabel(incoming);
     auto incomingAuxVars = getAuxiliaryVariablesFromEdge(graph, incoming);
     if (incomingAuxVars.empty()) { return incomingLabel; }
-    static std::size_t counter = 0;
+    static std::atomic<std::size_t> counter{0}; // Engines of a portfolio preprocess their systems concurrently
     Logic & logic = graph.getLogic();
     TermUtils::substitutions_map substitutionsMap;
     TimeMachine tm(logic);
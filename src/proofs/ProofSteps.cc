@@ -493,14 +493,14 @@ StepHandler::getInstPairs(std::size_t stepIndex, vec<Normalizer::Equality> const
         PTRef instantiatedConstraint = utils.varSubstitute(originalConstraint, substitutionsMap);
         assert(instantiatedConstraint != logic.getTerm_false());
         // Find values for auxiliary variables
-        SMTSolver solver(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-        solver.getCoreSolver().insertFormula(instantiatedConstraint);
-        auto res = solver.getCoreSolver().check();
+        auto solver = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+        solver->getCoreSolver().insertFormula(instantiatedConstraint);
+        auto res = solver->getCoreSolver().check();
         if (res != s_True) {
             assert(false);
             throw std::logic_error("Formula should have been satisfiable");
         }
-        auto model = solver.getCoreSolver().getModel();
+        auto model = solver->getCoreSolver().getModel();
         for (PTRef auxVar : auxVars) {
             PTRef val = model->evaluate(auxVar);
             auto it = std::find_if(stepNormEq.begin(), stepNormEq.end(),
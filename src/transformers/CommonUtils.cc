@@ -50,8 +50,8 @@ InvalidityWitness::Derivation replaceSummarizingStep(
     utils.mapFromPredicate(targetPredicate, summarizedStep.derivedFact, subst);
     utils.mapFromPredicate(sourcePredicate, derivation[summarizedStep.premises.front()].derivedFact, subst);
 
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(logic.mkAnd(std::move(edgeConstraints)));
     for (auto const & [var,value] : subst) {
         assert(logic.isVar(var) and logic.isConstant(value));
@@ -167,8 +167,8 @@ InvalidityWitness::Derivation expandStepWithHyperEdge(
         }
     }
 
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(unifiedConstraint);
     for (auto const & [var,value] : subst) {
         assert(logic.isVar(var) and logic.isConstant(value));
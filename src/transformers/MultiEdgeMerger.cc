@@ -65,8 +65,8 @@ InvalidityWitness MultiEdgeMerger::BackTranslator::translate(InvalidityWitness w
             // No edge evaluate to true, try to find one with satisfiable label
             for (std::size_t i = 0u; i < evaluatedLabels.size(); ++i) {
                 if (evaluatedLabels[i] == logic.getTerm_false()) { continue; }
-                SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-                auto & solver = solverWrapper.getCoreSolver();
+                auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+                auto & solver = solverWrapper->getCoreSolver();
                 solver.insertFormula(evaluatedLabels[i]);
                 if (solver.check() == s_True) { return i; }
             }
@@ -164,8 +164,8 @@ SingleLoopTransformation::WitnessBackTranslator::translateErrorPath(std::size_t
     // We need to get the CEX path, which will define the locations in the graph
     Logic & logic = graph.getLogic();
     TimeMachine tm(logic);
-    SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
-    auto & solver = solverWrapper.getCoreSolver();
+    auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    auto & solver = solverWrapper->getCoreSolver();
     solver.insertFormula(transitionSystem.getInit());
     PTRef transition = transitionSystem.getTransition();
     for (auto i = 0u; i < unrolling; ++i) {
@@ -19,8 +19,8 @@ Transformer::TransformationResult TrivialEdgePruner::transform(std::unique_ptr<C
     Logic & logic = graph->getLogic();
     // Test if any edge is satisfiable
     for (EId eid : directEdges) {
-        SMTSolver solverWrapper(logic, SMTSolver::WitnessProduction::NONE);
-        auto & solver = solverWrapper.getCoreSolver();
+        auto solverWrapper = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        auto & solver = solverWrapper->getCoreSolver();
         solver.insertFormula(graph->getEdgeLabel(eid));
         auto res = solver.check();
         if (res == s_True) {
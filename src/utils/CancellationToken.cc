@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "CancellationToken.h"
+
+#include "include/osmt_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <unordered_set>
+#include <vector>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+struct CancellationToken::State {
+    std::atomic<bool> stopped{false};
+    std::atomic<StopReason> reason{StopReason::NONE};
+    Budget budget;
+    std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+    std::atomic<std::chrono::steady_clock::rep> lastMemoryCheck{0}; // Time since start
+    std::mutex solversMutex;
+    std::unordered_set<MainSolver *> solvers;
+    CancellationToken parent;
+    std::vector<std::weak_ptr<State>> children; // Guarded by solversMutex
+};
+
+namespace {
+// Resident memory of the process now; unlike the peak, it goes down again when memory is released
+std::size_t currentMemoryMB() {
+#ifdef __APPLE__
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<std::size_t>(info.resident_size) / (1024 * 1024);
+#else
+    std::ifstream statm("/proc/self/statm");
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (not(statm >> totalPages >> residentPages)) { return 0; }
+    return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+#endif
+}
+
+// Reading the memory usage is a system call, while the token is polled in hot loops
+constexpr std::chrono::milliseconds memoryCheckInterval{50};
+
+thread_local CancellationToken currentToken;
+} // namespace
+
+CancellationToken CancellationToken::create(Budget budget) {
+    CancellationToken token;
+    token.state = std::make_shared<State>();
+    token.state->budget = budget;
+    return token;
+}
+
+CancellationToken CancellationToken::createChild() const {
+    auto child = create();
+    if (not state) { return child; }
+    child.state->parent = *this;
+    {
+        std::lock_guard<std::mutex> lock(state->solversMutex);
+        auto & children = state->children;
+        children.erase(std::remove_if(children.begin(), children.end(), [](auto const & c) { return c.expired(); }),
+                       children.end());
+        children.push_back(child.state);
+    }
+    if (state->stopped.load()) { child.requestStop(state->reason.load()); }
+    return child;
+}
+
+void CancellationToken::requestStop(StopReason reason) const {
+    if (not state) { return; }
+    auto expected = StopReason::NONE;
+    state->reason.compare_exchange_strong(expected, reason);
+    state->stopped.store(true);
+    std::vector<std::weak_ptr<State>> children;
+    {
+        std::lock_guard<std::mutex> lock(state->solversMutex);
+        for (MainSolver * solver : state->solvers) {
+            solver->stop();
+        }
+        children = state->children;
+    }
+    for (auto const & weakChild : children) {
+        CancellationToken child;
+        child.state = weakChild.lock();
+        child.requestStop(reason);
+    }
+}
+
+bool CancellationToken::stopRequested() const {
+    if (not state) { return false; }
+    if (state->stopped.load(std::memory_order_relaxed)) { return true; }
+    if (state->parent.stopRequested()) { return true; }
+    auto const & budget = state->budget;
+    if (not budget.time.has_value() and not budget.memoryMB.has_value()) { return false; }
+    auto elapsed = std::chrono::steady_clock::now() - state->start;
+    if (budget.time.has_value() and elapsed >= budget.time.value()) {
+        requestStop(StopReason::TIME_LIMIT);
+        return true;
+    }
+    if (budget.memoryMB.has_value()) {
+        auto lastCheck = state->lastMemoryCheck.load(std::memory_order_relaxed);
+        bool due = elapsed.count() - lastCheck >= std::chrono::steady_clock::duration(memoryCheckInterval).count();
+        if (due and state->lastMemoryCheck.compare_exchange_strong(lastCheck, elapsed.count())) {
+            if (currentMemoryMB() > budget.memoryMB.value()) {
+                requestStop(StopReason::MEMORY_LIMIT);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+CancellationToken::StopReason CancellationToken::stopReason() const {
+    return state ? state->reason.load() : StopReason::NONE;
+}
+
+std::string CancellationToken::describeStop() const {
+    switch (stopReason()) {
+        case StopReason::NONE:
+            return "not stopped";
+        case StopReason::CANCELLED:
+            return "cancelled";
+        case StopReason::TIME_LIMIT:
+            return "time limit exhausted";
+        case StopReason::MEMORY_LIMIT:
+            return "memory limit exhausted";
+    }
+    return "unknown reason";
+}
+
+bool CancellationToken::hasBudget() const {
+    return state and (state->budget.time.has_value() or state->budget.memoryMB.has_value());
+}
+
+void CancellationToken::registerSolver(MainSolver & solver) const {
+    if (not state) { return; }
+    std::lock_guard<std::mutex> lock(state->solversMutex);
+    state->solvers.insert(&solver);
+    if (state->stopped.load()) { solver.stop(); }
+}
+
+void CancellationToken::unregisterSolver(MainSolver & solver) const {
+    if (not state) { return; }
+    std::lock_guard<std::mutex> lock(state->solversMutex);
+    state->solvers.erase(&solver);
+}
+
+CancellationToken const & CancellationToken::current() {
+    return currentToken;
+}
+
+CancellationToken::Scope::Scope(CancellationToken const & token) : previous(currentToken) {
+    currentToken = token;
+}
+
+CancellationToken::Scope::~Scope() {
+    currentToken = std::move(previous);
+}
+
+CancellationToken::Watchdog::Watchdog(CancellationToken token) : token(std::move(token)) {
+    if (not this->token.hasBudget()) { return; }
+    thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (not done and not this->token.stopRequested()) {
+            wakeUp.wait_for(lock, std::chrono::milliseconds(50));
+        }
+    });
+}
+
+CancellationToken::Watchdog::~Watchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    wakeUp.notify_one();
+    if (thread.joinable()) { thread.join(); }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_CANCELLATIONTOKEN_H
+#define GOLEM_CANCELLATIONTOKEN_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+class MainSolver;
+
+/**
+ * Cooperative cancellation of a running engine, optionally bounded by time and memory budgets.
+ *
+ * All copies of a token share the same state; a stop requested through one copy is observed by all of them.
+ * Exhausting a budget counts as a stop request. OpenSMT solvers registered with the token are stopped as well, so that
+ * a stop also interrupts a long-running satisfiability check.
+ * A default-constructed token can never be cancelled, so engines running on their own do not need to care.
+ */
+class CancellationToken {
+public:
+    struct Budget {
+        std::optional<std::chrono::milliseconds> time;
+        std::optional<std::size_t> memoryMB; // Resident memory of the whole process, engines in a portfolio share it
+    };
+
+    enum class StopReason : char { NONE, CANCELLED, TIME_LIMIT, MEMORY_LIMIT };
+
+    CancellationToken() = default;
+
+    static CancellationToken create(Budget budget = {});
+
+    /**
+     * A new token that is stopped whenever this token is stopped, but can also be stopped on its own.
+     * Used to stop the helper threads of an engine without stopping the engine itself.
+     */
+    [[nodiscard]] CancellationToken createChild() const;
+
+    void requestStop() const { requestStop(StopReason::CANCELLED); }
+
+    [[nodiscard]] bool stopRequested() const;
+
+    [[nodiscard]] StopReason stopReason() const;
+
+    [[nodiscard]] std::string describeStop() const;
+
+    [[nodiscard]] bool hasBudget() const;
+
+    void registerSolver(MainSolver & solver) const;
+    void unregisterSolver(MainSolver & solver) const;
+
+    /**
+     * The token of the engine running in the calling thread. Solvers created through SMTSolver register with it.
+     */
+    static CancellationToken const & current();
+
+    /**
+     * Makes the given token current for the calling thread during the lifetime of the scope.
+     */
+    class Scope {
+        CancellationToken previous;
+
+    public:
+        explicit Scope(CancellationToken const & token);
+        ~Scope();
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+    };
+
+    /**
+     * Periodically checks the budget of a token in a background thread. Without it, a budget is only checked when an
+     * engine polls the token, which does not happen while a solver is running.
+     */
+    class Watchdog {
+        CancellationToken token;
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        bool done = false;
+        std::thread thread;
+
+    public:
+        explicit Watchdog(CancellationToken token);
+        ~Watchdog();
+        Watchdog(Watchdog const &) = delete;
+        Watchdog & operator=(Watchdog const &) = delete;
+    };
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+
+    void requestStop(StopReason reason) const;
+};
+
+#endif // GOLEM_CANCELLATIONTOKEN_H
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "LemmaBus.h"
+
+namespace {
+vec<PTRef> argumentsOf(Logic & logic, PTRef predicateInstance) {
+    vec<PTRef> arguments;
+    for (PTRef arg : logic.getPterm(predicateInstance)) {
+        arguments.push(arg);
+    }
+    return arguments;
+}
+} // namespace
+
+LemmaBus::Subscription::Subscription(LemmaBus & bus, Logic & logic) : bus(bus), logic(logic) {
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    id = bus.subscribers++;
+}
+
+bool LemmaBus::Subscription::publish(PTRef predicateInstance, PTRef fact) {
+    Entry entry{.publisher = id, .predicate = logic.getSymName(predicateInstance), .fact = {}};
+    if (not encode(logic, fact, argumentsOf(logic, predicateInstance), entry.fact)) { return false; }
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    bus.entries.push_back(std::move(entry));
+    return true;
+}
+
+std::vector<LemmaBus::ReceivedFact> LemmaBus::Subscription::receive(vec<PTRef> const & predicateInstances) {
+    std::vector<Entry> newEntries;
+    {
+        std::lock_guard<std::mutex> lock(bus.mutex);
+        newEntries.assign(bus.entries.begin() + static_cast<std::ptrdiff_t>(next), bus.entries.end());
+        next = bus.entries.size();
+    }
+    std::vector<ReceivedFact> received;
+    for (auto const & entry : newEntries) {
+        if (entry.publisher == id) { continue; }
+        for (PTRef instance : predicateInstances) {
+            if (logic.getSymName(instance) != entry.predicate) { continue; }
+            PTRef fact = decode(logic, entry.fact, argumentsOf(logic, instance));
+            if (fact != PTRef_Undef) { received.push_back({instance, fact}); }
+        }
+    }
+    return received;
+}
+
+bool LemmaBus::encode(Logic & logic, PTRef term, vec<PTRef> const & arguments, Node & node) {
+    if (logic.isVar(term)) {
+        for (int i = 0; i < arguments.size(); ++i) {
+            if (arguments[i] == term) {
+                node.kind = Node::Kind::ARGUMENT;
+                node.position = static_cast<std::size_t>(i);
+                return true;
+            }
+        }
+        return false; // Not an argument of the predicate, the fact cannot be expressed in other logics
+    }
+    node.symbol = logic.getSymName(term);
+    auto const & pterm = logic.getPterm(term);
+    if (pterm.nargs() == 0) {
+        node.kind = Node::Kind::CONSTANT;
+        return true;
+    }
+    node.kind = Node::Kind::APPLICATION;
+    node.args.resize(pterm.nargs());
+    for (int i = 0; i < pterm.nargs(); ++i) {
+        if (not encode(logic, pterm[i], arguments, node.args[i])) { return false; }
+    }
+    return true;
+}
+
+PTRef LemmaBus::decode(Logic & logic, Node const & node, vec<PTRef> const & arguments) {
+    switch (node.kind) {
+        case Node::Kind::ARGUMENT:
+            return node.position < static_cast<std::size_t>(arguments.size()) ? arguments[node.position] : PTRef_Undef;
+        case Node::Kind::CONSTANT:
+            if (node.symbol == "true") { return logic.getTerm_true(); }
+            if (node.symbol == "false") { return logic.getTerm_false(); }
+            if (node.symbol.front() == '-') { // Negative numerals are built the same way as when parsing the input
+                return logic.resolveTerm("-", {logic.mkConst(node.symbol.substr(1).c_str())});
+            }
+            return logic.mkConst(node.symbol.c_str());
+        case Node::Kind::APPLICATION: {
+            vec<PTRef> args;
+            args.capacity(static_cast<int>(node.args.size()));
+            for (auto const & arg : node.args) {
+                PTRef decoded = decode(logic, arg, arguments);
+                if (decoded == PTRef_Undef) { return PTRef_Undef; }
+                args.push(decoded);
+            }
+            return logic.resolveTerm(node.symbol.c_str(), std::move(args));
+        }
+    }
+    return PTRef_Undef;
+}
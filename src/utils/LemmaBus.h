@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_LEMMABUS_H
+#define GOLEM_LEMMABUS_H
+
+#include "osmt_terms.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Channel for exchanging proven facts between the engines of a portfolio.
+ *
+ * A fact about a predicate is an invariant of the predicate: it holds for all tuples in the least interpretation of the
+ * predicate. It is expressed over the arguments of an instance of the predicate. Engines receiving the fact may use it
+ * as a strengthening hint without further checks.
+ *
+ * Each engine of a portfolio works in its own Logic, so the facts are stored in a logic-independent form. Predicates
+ * are identified by their names and variables by their position in the arguments of the predicate.
+ */
+class LemmaBus {
+    struct Node {
+        enum class Kind : char { ARGUMENT, CONSTANT, APPLICATION };
+        Kind kind;
+        std::string symbol;
+        std::size_t position{0};
+        std::vector<Node> args;
+    };
+
+    struct Entry {
+        std::size_t publisher;
+        std::string predicate;
+        Node fact;
+    };
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::size_t subscribers{0};
+
+public:
+    struct ReceivedFact {
+        PTRef predicateInstance;
+        PTRef fact;
+    };
+
+    /**
+     * Connection of a single engine to the bus. It must be used only from the thread of the engine.
+     */
+    class Subscription {
+        LemmaBus & bus;
+        Logic & logic;
+        std::size_t id;
+        std::size_t next{0};
+
+    public:
+        Subscription(LemmaBus & bus, Logic & logic);
+
+        /**
+         * Publishes a fact over the arguments of the given predicate instance.
+         * @return false if the fact cannot be shared, e.g., because it contains other variables than the arguments
+         */
+        bool publish(PTRef predicateInstance, PTRef fact);
+
+        /**
+         * Collects the facts published by other engines since the last call for the predicates of the given instances.
+         * Each received fact is expressed over the arguments of the corresponding instance.
+         */
+        std::vector<ReceivedFact> receive(vec<PTRef> const & predicateInstances);
+    };
+
+private:
+    static bool encode(Logic & logic, PTRef term, vec<PTRef> const & arguments, Node & node);
+    static PTRef decode(Logic & logic, Node const & node, vec<PTRef> const & arguments);
+};
+
+#endif // GOLEM_LEMMABUS_H
@@ -6,16 +6,193 @@
 
 #include "SmtSolver.h"
 
-SMTSolver::SMTSolver(Logic & logic, WitnessProduction setup) {
-    bool produceModel = setup == WitnessProduction::ONLY_MODEL || setup == WitnessProduction::MODEL_AND_INTERPOLANTS;
+SMTSolver::SMTSolver(Logic & logic, WitnessProduction setup)
+    : cancellationToken(CancellationToken::current()),
+      produceModels(setup == WitnessProduction::ONLY_MODEL || setup == WitnessProduction::MODEL_AND_INTERPOLANTS) {
     bool produceInterpolants =
         setup == WitnessProduction::ONLY_INTERPOLANTS || setup == WitnessProduction::MODEL_AND_INTERPOLANTS;
     const char * msg = "ok";
-    this->config.setOption(SMTConfig::o_produce_models, SMTOption(produceModel), msg);
+    this->config.setOption(SMTConfig::o_produce_models, SMTOption(produceModels), msg);
     this->config.setOption(SMTConfig::o_produce_inter, SMTOption(produceInterpolants), msg);
     solver = std::make_unique<MainSolver>(logic, config, "");
+    cancellationToken.registerSolver(*solver);
+}
+
+SMTSolver::~SMTSolver() {
+    cancellationToken.unregisterSolver(*solver);
 }
 
 void SMTSolver::resetSolver() {
+    forgetAssumptions();
+    cancellationToken.unregisterSolver(*solver);
     solver = std::make_unique<MainSolver>(solver->getLogic(), config, "");
+    cancellationToken.registerSolver(*solver);
+}
+
+void SMTSolver::push() {
+    solver->push();
+    frames.push_back(activatedAssumptions.size());
+}
+
+bool SMTSolver::pop() {
+    if (not solver->pop()) { return false; }
+    if (not frames.empty()) {
+        for (auto i = frames.back(); i < activatedAssumptions.size(); ++i) {
+            activationLiterals.erase(activatedAssumptions[i]);
+        }
+        activatedAssumptions.resize(frames.back());
+        frames.pop_back();
+    }
+    return true;
+}
+
+void SMTSolver::forgetAssumptions() {
+    activationLiterals.clear();
+    activatedAssumptions.clear();
+    frames.clear();
+    lastAssumptions.clear();
+    lastModel.reset();
+}
+
+PTRef SMTSolver::activationLiteral(PTRef assumption) {
+    auto it = activationLiterals.find(assumption);
+    if (it != activationLiterals.end()) { return it->second; }
+    Logic & logic = solver->getLogic();
+    // Literals are named by their position, so a literal released by a pop is reused for the next assumption
+    std::string name = ".act" + std::to_string(activatedAssumptions.size());
+    PTRef literal = logic.mkBoolVar(name.c_str());
+    solver->insertFormula(logic.mkOr(logic.mkNot(literal), assumption));
+    activationLiterals.insert({assumption, literal});
+    activatedAssumptions.push_back(assumption);
+    return literal;
+}
+
+PTRef SMTSolver::literalFor(PTRef assumption) {
+    Logic & logic = solver->getLogic();
+    PTRef atom = logic.isNot(assumption) ? logic.getPterm(assumption)[0] : assumption;
+    bool isLiteral = logic.isVar(atom) and logic.hasSortBool(atom);
+    return isLiteral ? assumption : activationLiteral(assumption);
+}
+
+sstat SMTSolver::checkUnderAssumptions(vec<PTRef> const & assumptions) {
+    vec<PTRef> literals;
+    literals.capacity(assumptions.size());
+    for (PTRef assumption : assumptions) {
+        literals.push(literalFor(assumption));
+    }
+    assumptions.copyTo(lastAssumptions);
+    return checkActivated(literals);
+}
+
+sstat SMTSolver::checkUnderAssumptions(vec<PTRef> const & assumptions, PTRef temporary) {
+    for (PTRef assumption : assumptions) {
+        literalFor(assumption);
+    }
+    push();
+    solver->insertFormula(temporary);
+    auto res = checkUnderAssumptions(assumptions);
+    pop(); // Keeps the model of the query
+    lastAssumptions.clear();
+    return res;
+}
+
+sstat SMTSolver::checkActivated(vec<PTRef> const & literals) {
+    lastModel.reset();
+    solver->push();
+    for (PTRef literal : literals) {
+        solver->insertFormula(literal);
+    }
+    auto res = solver->check();
+    if (res == s_True and produceModels) { lastModel = solver->getModel(); }
+    solver->pop();
+    return res;
+}
+
+vec<PTRef> SMTSolver::getUnsatCore() {
+    std::vector<PTRef> assumptions(lastAssumptions.begin(), lastAssumptions.end());
+    vec<PTRef> core;
+    if (assumptions.empty()) { return core; }
+    for (PTRef assumption : minimalCore({}, false, assumptions)) {
+        core.push(assumption);
+    }
+    return core;
+}
+
+/*
+ * QuickXplain: the background together with all candidates is unsatisfiable; the result is a minimal subset of the
+ * candidates that is unsatisfiable with the background. A check that does not come back unsatisfiable (e.g., because the
+ * solver has been stopped) keeps the candidates, so the result is then still a core, only not minimal.
+ */
+std::vector<PTRef> SMTSolver::minimalCore(std::vector<PTRef> const & background, bool checkBackground,
+                                          std::vector<PTRef> const & candidates) {
+    auto isUnsat = [&](std::vector<PTRef> const & assumptions) {
+        vec<PTRef> literals;
+        for (PTRef assumption : assumptions) {
+            auto it = activationLiterals.find(assumption);
+            literals.push(it != activationLiterals.end() ? it->second : assumption);
+        }
+        return checkActivated(literals) == s_False;
+    };
+    if (checkBackground and isUnsat(background)) { return {}; }
+    if (candidates.size() == 1) { return candidates; }
+    auto middle = candidates.begin() + static_cast<std::ptrdiff_t>(candidates.size() / 2);
+    std::vector<PTRef> first(candidates.begin(), middle);
+    std::vector<PTRef> second(middle, candidates.end());
+    std::vector<PTRef> extended = background;
+    extended.insert(extended.end(), first.begin(), first.end());
+    auto secondCore = minimalCore(extended, true, second);
+    extended = background;
+    extended.insert(extended.end(), secondCore.begin(), secondCore.end());
+    auto firstCore = minimalCore(extended, not secondCore.empty(), first);
+    firstCore.insert(firstCore.end(), secondCore.begin(), secondCore.end());
+    return firstCore;
+}
+
+namespace {
+thread_local SMTSolverPool * currentPool = nullptr;
+
+bool producesInterpolants(SMTSolver::WitnessProduction setup) {
+    return setup == SMTSolver::WitnessProduction::ONLY_INTERPOLANTS ||
+           setup == SMTSolver::WitnessProduction::MODEL_AND_INTERPOLANTS;
+}
+} // namespace
+
+SMTSolverPool::Lease SMTSolverPool::acquire(Logic & logic, SMTSolver::WitnessProduction setup) {
+    SMTSolverPool * pool = producesInterpolants(setup) ? nullptr : currentPool;
+    if (not pool) { return Lease(std::make_unique<SMTSolver>(logic, setup), nullptr, setup); }
+    auto & solvers = pool->available[{&logic, setup}];
+    std::unique_ptr<SMTSolver> solver;
+    if (solvers.empty()) {
+        solver = std::make_unique<SMTSolver>(logic, setup);
+    } else {
+        solver = std::move(solvers.back());
+        solvers.pop_back();
+    }
+    ++solver->leases;
+    solver->push(); // Everything asserted by the user goes into this frame
+    return Lease(std::move(solver), pool, setup);
+}
+
+SMTSolverPool::Lease::Lease(std::unique_ptr<SMTSolver> solver, SMTSolverPool * pool, SMTSolver::WitnessProduction setup)
+    : solver(std::move(solver)), pool(pool), setup(setup) {}
+
+SMTSolverPool::Lease::~Lease() {
+    if (not solver or not pool) { return; }
+    // A stopped solver cannot be used anymore
+    if (CancellationToken::current().stopRequested()) { return; }
+    if (solver->leases >= maxLeases) { return; }
+    Logic & logic = solver->getCoreSolver().getLogic();
+    auto & solvers = pool->available[{&logic, setup}];
+    if (solvers.size() >= maxIdleSolvers) { return; }
+    while (solver->pop()) {} // The user may have pushed more frames
+    solver->forgetAssumptions();
+    solvers.push_back(std::move(solver));
+}
+
+SMTSolverPool::Scope::Scope() : pool(std::make_unique<SMTSolverPool>()), previous(currentPool) {
+    currentPool = pool.get();
+}
+
+SMTSolverPool::Scope::~Scope() {
+    currentPool = previous;
 }
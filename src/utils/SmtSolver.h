@@ -8,13 +8,32 @@
 #define GOLEM_SMTSOLVER_H
 
 #include "include/osmt_solver.h"
+#include "utils/CancellationToken.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 /**
  * Simple wrapper around OpenSMT's MainSolver and SMTConfig
+ *
+ * The solver is registered with the cancellation token of the engine running in the current thread (if any),
+ * so that cancelling the engine also stops the solver.
  */
 class SMTSolver {
     std::unique_ptr<MainSolver> solver;
     SMTConfig config;
+    CancellationToken cancellationToken;
+    bool produceModels;
+
+    std::unordered_map<PTRef, PTRef, PTRefHash> activationLiterals; // assumption -> its activation literal
+    std::vector<PTRef> activatedAssumptions; // in the order of activation
+    std::vector<std::size_t> frames;         // number of activated assumptions when a frame was pushed
+    vec<PTRef> lastAssumptions;
+    std::unique_ptr<Model> lastModel;
+    std::size_t leases{0}; // Number of times the solver has been handed out by a pool
+
+    friend class SMTSolverPool;
 
 public:
     enum class WitnessProduction { NONE, ONLY_MODEL, ONLY_INTERPOLANTS, MODEL_AND_INTERPOLANTS };
@@ -22,11 +41,131 @@ public:
     // Default setup in OpenSMT is currently to produce models, but not interpolants
     explicit SMTSolver(Logic & logic, WitnessProduction setup = WitnessProduction::ONLY_MODEL);
 
+    ~SMTSolver();
+    SMTSolver(SMTSolver const &) = delete;
+    SMTSolver & operator=(SMTSolver const &) = delete;
+
     MainSolver & getCoreSolver() { return *solver; }
 
     SMTConfig & getConfig() { return config; }
 
     void resetSolver();
+
+    /**
+     * Pushes a new assertion frame. Activation literals of assumptions first used in this frame are recycled when the
+     * frame is popped, so solvers using assumptions should push and pop through the wrapper.
+     */
+    void push();
+    bool pop();
+
+    /**
+     * Checks the satisfiability of the asserted formulas together with the given assumptions, without asserting them.
+     *
+     * Each assumption (other than a Boolean literal) is guarded by an activation literal, which is asserted once in the
+     * current frame and reused by later queries with the same assumption. Clauses learned by the solver thus remain
+     * valid across queries. After a satisfiable query, the model is available from getModel(); after an unsatisfiable
+     * query, getUnsatCore() gives the assumptions responsible.
+     */
+    sstat checkUnderAssumptions(vec<PTRef> const & assumptions);
+
+    /**
+     * As above, but the given formula is asserted for this query only. The activation literals of the assumptions are
+     * registered in the current frame before the formula is pushed, so they are reused by later queries.
+     * The unsat core of such a query is not available.
+     */
+    sstat checkUnderAssumptions(vec<PTRef> const & assumptions, PTRef temporary);
+
+    /**
+     * The activation literal guarding the given assumption; the assumption holds whenever the literal is true.
+     */
+    PTRef activationLiteral(PTRef assumption);
+
+    bool isActivated(PTRef assumption) const { return activationLiterals.count(assumption) != 0; }
+
+    /** Number of activation literals currently asserted; each guards one assumption with a permanent clause */
+    std::size_t activationCount() const { return activatedAssumptions.size(); }
+
+    /**
+     * Model of the last satisfiable query under assumptions. The model is handed over to the caller.
+     */
+    std::unique_ptr<Model> getModel() { return std::move(lastModel); }
+
+    /**
+     * Subset of the assumptions of the last unsatisfiable query that is unsatisfiable with the asserted formulas.
+     * The subset is minimal. OpenSMT does not report which assumptions were used, so the core is found by checking
+     * subsets of the assumptions: splitting them in halves takes O(k log(n/k)) checks for a core of k out of n
+     * assumptions. Each check is a full solver call, so callers should ask for cores only when n is small or the core
+     * pays off.
+     */
+    vec<PTRef> getUnsatCore();
+
+private:
+    PTRef literalFor(PTRef assumption);
+    /**
+     * Checks the asserted formulas with the given literals. The literals are asserted as units in a temporary frame;
+     * clauses learned from them are lost when the frame is popped.
+     */
+    sstat checkActivated(vec<PTRef> const & literals);
+    std::vector<PTRef> minimalCore(std::vector<PTRef> const & background, bool checkBackground,
+                                   std::vector<PTRef> const & candidates);
+    void forgetAssumptions();
+};
+
+/**
+ * Recycles solvers for one-shot queries, which would otherwise pay for constructing and destroying a solver each time.
+ *
+ * A pool is active in the calling thread during the lifetime of a Scope. A leased solver is handed out inside a fresh
+ * assertion frame, which is popped when the lease ends and the solver is returned to the pool. Solvers producing
+ * interpolants are never pooled: callers tune their configuration and interpolation relies on the partitions of a fresh
+ * solver. Without an active pool, every lease creates a new solver.
+ *
+ * Popping the frames does not remove everything a solver has accumulated (e.g., learned clauses and internal
+ * structures for terms it has seen), so a solver is dropped after a fixed number of leases. The number of idle solvers
+ * per logic and setup is bounded as well; a solver returned to a full pool is dropped.
+ */
+class SMTSolverPool {
+    static constexpr std::size_t maxLeases = 100;
+    static constexpr std::size_t maxIdleSolvers = 4;
+
+    std::map<std::pair<Logic *, SMTSolver::WitnessProduction>, std::vector<std::unique_ptr<SMTSolver>>> available;
+
+public:
+    class Lease {
+        std::unique_ptr<SMTSolver> solver;
+        SMTSolverPool * pool;
+        SMTSolver::WitnessProduction setup;
+
+    public:
+        Lease(std::unique_ptr<SMTSolver> solver, SMTSolverPool * pool, SMTSolver::WitnessProduction setup);
+        ~Lease();
+        Lease(Lease &&) = default;
+        Lease & operator=(Lease &&) = delete;
+        Lease(Lease const &) = delete;
+        Lease & operator=(Lease const &) = delete;
+
+        SMTSolver & operator*() { return *solver; }
+        SMTSolver * operator->() { return solver.get(); }
+    };
+
+    /**
+     * Hands out a solver with no assertions from the pool of the calling thread.
+     */
+    static Lease acquire(Logic & logic, SMTSolver::WitnessProduction setup);
+
+    /**
+     * Makes a new pool active in the calling thread during the lifetime of the scope. The logic of pooled solvers must
+     * outlive the scope.
+     */
+    class Scope {
+        std::unique_ptr<SMTSolverPool> pool;
+        SMTSolverPool * previous;
+
+    public:
+        Scope();
+        ~Scope();
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+    };
 };
 
 #endif // GOLEM_SMTSOLVER_H
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "TermTranslator.h"
+
+PTRef TermTranslator::translate(PTRef term) {
+    auto it = cache.find(term);
+    if (it != cache.end()) { return it->second; }
+    PTRef translated = PTRef_Undef;
+    if (term == source.getTerm_true()) {
+        translated = target.getTerm_true();
+    } else if (term == source.getTerm_false()) {
+        translated = target.getTerm_false();
+    } else if (source.isVar(term)) {
+        translated = target.mkVar(translateSort(source.getSortRef(term)), source.getSymName(term));
+    } else if (source.isNumConst(term)) {
+        translated = target.mkConst(translateSort(source.getSortRef(term)), source.getNumConst(term));
+    } else {
+        auto const & pterm = source.getPterm(term);
+        vec<PTRef> args;
+        args.capacity(pterm.nargs());
+        for (int i = 0; i < pterm.nargs(); ++i) {
+            args.push(translate(pterm[i]));
+        }
+        translated = target.resolveTerm(source.getSymName(term), std::move(args));
+    }
+    cache.insert({term, translated});
+    return translated;
+}
+
+SRef TermTranslator::translateSort(SRef sort) const {
+    if (sort == source.getSort_bool()) { return target.getSort_bool(); }
+    if (sort == source.getSort_int()) { return target.getSort_int(); }
+    if (sort == source.getSort_real()) { return target.getSort_real(); }
+    throw std::logic_error("Unsupported sort in term translation");
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef GOLEM_TERMTRANSLATOR_H
+#define GOLEM_TERMTRANSLATOR_H
+
+#include "osmt_terms.h"
+
+#include <unordered_map>
+
+/**
+ * Rebuilds terms of one arithmetic logic in another logic of the same kind.
+ *
+ * OpenSMT's term store is not thread-safe, so work distributed to other threads must be expressed in logics owned by
+ * those threads. Variables are identified by their names and sorts. Translation only reads the source logic, so
+ * several translators may read the same source logic concurrently, as long as no thread modifies it.
+ */
+class TermTranslator {
+    ArithLogic & source;
+    ArithLogic & target;
+    std::unordered_map<PTRef, PTRef, PTRefHash> cache;
+
+public:
+    TermTranslator(ArithLogic & source, ArithLogic & target) : source(source), target(target) {}
+
+    PTRef translate(PTRef term);
+
+private:
+    SRef translateSort(SRef sort) const;
+};
+
+#endif // GOLEM_TERMTRANSLATOR_H
@@ -141,3 +141,62 @@ TEST_F(BMCTest, test_KIND_BeyondTransitionSystemWithAuxVar_unsafe)
     BMC engine(*logic, options);
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
 }
+
+TEST_F(BMCTest, test_BMC_StoppedByTimeLimit)
+{
+    Options options;
+    options.addOption(Options::LOGIC, "QF_LIA");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    // x' = 0 => S1(x')
+    // S1(x) and x' = x + 1 => S1(x')
+    // S1(x) and x < 0 => false
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkLt(x, zero)}, {UninterpretedPredicate{current}}}
+        }};
+    BMC engine(*logic, options);
+    // The system is safe, BMC alone never terminates on it
+    engine.setCancellationToken(CancellationToken::create({std::chrono::milliseconds(0), std::nullopt}));
+    solveSystem(clauses, engine, VerificationAnswer::UNKNOWN, false);
+}
+
+TEST_F(BMCTest, test_BMC_WorkersWithJumps_unsafe)
+{
+    options.addOption(Options::LOGIC, "QF_LIA");
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::BMC_THREADS, "2");
+    options.addOption(Options::BMC_JUMP, "3");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    // x' = 0 => S1(x')
+    // S1(x) and x < 7 and x' = x + 1 => S1(x')
+    // S1(x) and x = 7 => false
+    // The transition relation is not total, the counterexample has to end inside a window
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkLt(x, logic->mkIntConst(7)), logic->mkEq(xp, logic->mkPlus(x, one)))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkIntConst(7))}, {UninterpretedPredicate{current}}}
+        }};
+    BMC engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
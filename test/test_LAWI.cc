@@ -137,6 +137,34 @@ TEST_F(LAWI_LRA_Test, test_LAWI_simple_unsafe) {
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE);
 }
 
+TEST_F(LAWI_LRA_Test, test_LAWI_branchingLoop_unsafe) {
+    options.addOption(Options::LOGIC, "QF_LRA");
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    SymRef s1 = mkPredicateSymbol("s1", {realSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, two))}, {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkRealConst(FastRational(9)))}, {UninterpretedPredicate{current}}}
+        }
+    };
+    Lawi engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
 class LAWI_LIA_Test : public LIAEngineTest {
 };
 
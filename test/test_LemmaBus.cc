@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "utils/LemmaBus.h"
+
+class LemmaBus_Test : public ::testing::Test {
+protected:
+    ArithLogic publisherLogic {opensmt::Logic_t::QF_LIA};
+    ArithLogic consumerLogic {opensmt::Logic_t::QF_LIA};
+    LemmaBus bus;
+
+    static PTRef mkPredicateInstance(ArithLogic & logic, vec<PTRef> args) {
+        SymRef sym = logic.declareFun("P", logic.getSort_bool(), {logic.getSort_int(), logic.getSort_int()});
+        return logic.mkUninterpFun(sym, std::move(args));
+    }
+};
+
+TEST_F(LemmaBus_Test, test_FactTransferredBetweenLogics) {
+    PTRef x = publisherLogic.mkIntVar("x");
+    PTRef y = publisherLogic.mkIntVar("y");
+    PTRef instance = mkPredicateInstance(publisherLogic, {x, y});
+    PTRef fact = publisherLogic.mkAnd(publisherLogic.mkGeq(x, publisherLogic.getTerm_IntZero()),
+                                      publisherLogic.mkLeq(y, publisherLogic.mkPlus(x, publisherLogic.mkIntConst(-2))));
+    LemmaBus::Subscription publisher(bus, publisherLogic);
+    ASSERT_TRUE(publisher.publish(instance, fact));
+
+    PTRef a = consumerLogic.mkIntVar("a");
+    PTRef b = consumerLogic.mkIntVar("b");
+    PTRef consumerInstance = mkPredicateInstance(consumerLogic, {a, b});
+    LemmaBus::Subscription consumer(bus, consumerLogic);
+    auto received = consumer.receive({consumerInstance});
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(received[0].predicateInstance, consumerInstance);
+    PTRef expected = consumerLogic.mkAnd(consumerLogic.mkGeq(a, consumerLogic.getTerm_IntZero()),
+                                         consumerLogic.mkLeq(b, consumerLogic.mkPlus(a, consumerLogic.mkIntConst(-2))));
+    EXPECT_EQ(received[0].fact, expected);
+    // Facts are delivered only once, and never back to the publisher
+    EXPECT_TRUE(consumer.receive({consumerInstance}).empty());
+    EXPECT_TRUE(publisher.receive({instance}).empty());
+}
+
+TEST_F(LemmaBus_Test, test_FactWithOtherVariablesNotShared) {
+    PTRef x = publisherLogic.mkIntVar("x");
+    PTRef y = publisherLogic.mkIntVar("y");
+    PTRef z = publisherLogic.mkIntVar("z");
+    PTRef instance = mkPredicateInstance(publisherLogic, {x, y});
+    LemmaBus::Subscription publisher(bus, publisherLogic);
+    EXPECT_FALSE(publisher.publish(instance, publisherLogic.mkLeq(x, z)));
+}
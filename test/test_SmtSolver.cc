@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024, Martin Blicha <martin.blicha@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "utils/SmtSolver.h"
+
+class SMTSolverPool_Test : public ::testing::Test {
+protected:
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    PTRef x = logic.mkIntVar("x");
+};
+
+TEST_F(SMTSolverPool_Test, test_PooledSolverIsReusedWithoutAssertions) {
+    SMTSolverPool::Scope scope;
+    MainSolver * first = nullptr;
+    {
+        auto solver = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        first = &solver->getCoreSolver();
+        solver->getCoreSolver().insertFormula(logic.mkLt(x, logic.getTerm_IntZero()));
+        solver->getCoreSolver().push();
+        solver->getCoreSolver().insertFormula(logic.mkGt(x, logic.getTerm_IntZero()));
+        EXPECT_EQ(solver->getCoreSolver().check(), s_False);
+    }
+    auto solver = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+    EXPECT_EQ(&solver->getCoreSolver(), first);
+    solver->getCoreSolver().insertFormula(logic.mkGt(x, logic.getTerm_IntZero()));
+    EXPECT_EQ(solver->getCoreSolver().check(), s_True);
+}
+
+TEST_F(SMTSolverPool_Test, test_SolversArePooledPerWitnessProduction) {
+    SMTSolverPool::Scope scope;
+    MainSolver * first = nullptr;
+    {
+        auto solver = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::NONE);
+        first = &solver->getCoreSolver();
+    }
+    auto solver = SMTSolverPool::acquire(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    EXPECT_NE(&solver->getCoreSolver(), first);
+    solver->getCoreSolver().insertFormula(logic.mkEq(x, logic.mkIntConst(3)));
+    ASSERT_EQ(solver->getCoreSolver().check(), s_True);
+    EXPECT_EQ(solver->getCoreSolver().getModel()->evaluate(x), logic.mkIntConst(3));
+}
+
+class SMTSolverAssumptions_Test : public ::testing::Test {
+protected:
+    ArithLogic logic {opensmt::Logic_t::QF_LIA};
+    PTRef x = logic.mkIntVar("x");
+    PTRef y = logic.mkIntVar("y");
+    PTRef zero = logic.getTerm_IntZero();
+};
+
+TEST_F(SMTSolverAssumptions_Test, test_AssumptionsAreNotAsserted) {
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    solver.getCoreSolver().insertFormula(logic.mkGt(x, zero));
+    EXPECT_EQ(solver.checkUnderAssumptions({logic.mkLt(x, zero)}), s_False);
+    EXPECT_EQ(solver.checkUnderAssumptions({logic.mkEq(x, logic.mkIntConst(2))}), s_True);
+    auto model = solver.getModel();
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(model->evaluate(x), logic.mkIntConst(2));
+    EXPECT_EQ(solver.checkUnderAssumptions({}), s_True);
+}
+
+TEST_F(SMTSolverAssumptions_Test, test_UnsatCoreIsMinimal) {
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::NONE);
+    solver.getCoreSolver().insertFormula(logic.mkGt(x, zero));
+    PTRef irrelevant = logic.mkGt(y, zero);
+    PTRef conflicting = logic.mkLt(x, zero);
+    ASSERT_EQ(solver.checkUnderAssumptions({irrelevant, conflicting}), s_False);
+    auto core = solver.getUnsatCore();
+    ASSERT_EQ(core.size(), 1);
+    EXPECT_EQ(core[0], conflicting);
+}
+
+TEST_F(SMTSolverAssumptions_Test, test_UnsatCoreSpreadOverAssumptions) {
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::NONE);
+    PTRef lower = logic.mkGt(x, logic.mkIntConst(2));
+    PTRef upper = logic.mkLt(x, logic.mkIntConst(1));
+    vec<PTRef> assumptions{logic.mkGt(y, zero), lower, logic.mkLt(y, logic.mkIntConst(10)),
+                           logic.mkGt(y, logic.mkIntConst(5)), upper};
+    ASSERT_EQ(solver.checkUnderAssumptions(assumptions), s_False);
+    auto core = solver.getUnsatCore();
+    ASSERT_EQ(core.size(), 2);
+    EXPECT_EQ(core[0], lower);
+    EXPECT_EQ(core[1], upper);
+}
+
+TEST_F(SMTSolverAssumptions_Test, test_ActivationLiteralsAreRecycledAfterPop) {
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::NONE);
+    solver.push();
+    PTRef first = solver.activationLiteral(logic.mkGt(x, zero));
+    ASSERT_TRUE(solver.pop());
+    solver.push();
+    PTRef second = solver.activationLiteral(logic.mkLt(x, zero));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(solver.checkUnderAssumptions({logic.mkLt(x, zero), logic.mkGt(x, zero)}), s_False);
+    EXPECT_EQ(solver.checkUnderAssumptions({logic.mkLt(x, zero)}), s_True);
+}
+
+TEST_F(SMTSolverAssumptions_Test, test_ActivationLiteralsSurviveTemporaryFormula) {
+    // The pattern of Spacer's edge queries: summaries are assumptions, the proof obligation is temporary
+    SMTSolver solver(logic, SMTSolver::WitnessProduction::ONLY_MODEL);
+    solver.getCoreSolver().insertFormula(logic.mkGt(x, zero));
+    PTRef summary = logic.mkLt(y, x);
+    EXPECT_EQ(solver.checkUnderAssumptions({summary}, logic.mkLt(y, zero)), s_True);
+    ASSERT_TRUE(solver.isActivated(summary));
+    PTRef literal = solver.activationLiteral(summary);
+    auto model = solver.getModel();
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(model->evaluate(logic.mkLt(y, zero)), logic.getTerm_true());
+    EXPECT_EQ(solver.checkUnderAssumptions({summary}, logic.mkEq(y, x)), s_False);
+    ASSERT_TRUE(solver.isActivated(summary));
+    EXPECT_EQ(solver.activationLiteral(summary), literal);
+    // The temporary formulas are gone
+    EXPECT_EQ(solver.checkUnderAssumptions({summary}), s_True);
+}
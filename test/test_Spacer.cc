@@ -8,6 +8,24 @@
 #include "engine/Spacer.h"
 
 class Spacer_LRA_Test : public LRAEngineTest {
+protected:
+    // Solves the system sequentially and with push workers; both must give the expected answer with a valid witness
+    void solveSequentiallyAndInParallel(std::vector<ChClause> const & clauses, VerificationAnswer expectedAnswer) {
+        for (auto const & clause : clauses) { system.addClause(clause); }
+        auto normalizedSystem = Normalizer(*logic).normalize(system);
+        auto hypergraph = ChcGraphBuilder(*logic).buildGraph(normalizedSystem);
+        auto [simplifiedGraph, _] = ConstraintSimplifier{}.transform(std::move(hypergraph));
+        for (std::string threads : {"1", "2"}) {
+            Options engineOptions = options;
+            engineOptions.addOption(Options::COMPUTE_WITNESS, "true");
+            engineOptions.addOption(Options::SPACER_PUSH_THREADS, threads);
+            Spacer engine(*logic, engineOptions);
+            auto res = engine.solve(*simplifiedGraph);
+            ASSERT_EQ(res.getAnswer(), expectedAnswer) << "with " << threads << " push threads";
+            EXPECT_EQ(Validator(*logic).validate(*simplifiedGraph, res), Validator::Result::VALIDATED)
+                << "with " << threads << " push threads";
+        }
+    }
 };
 
 TEST_F(Spacer_LRA_Test, test_TransitionSystem)
@@ -105,6 +123,41 @@ TEST_F(Spacer_LRA_Test, test_BasicNonLinearSystem_Safe)
     solveSystem(clauses, engine, VerificationAnswer::SAFE);
 }
 
+TEST_F(Spacer_LRA_Test, test_BasicNonLinearSystem_ParallelPush)
+{
+    options.addOption(Options::SPACER_PUSH_THREADS, "2");
+    SymRef invx_sym = mkPredicateSymbol("Invx", {realSort()});
+    SymRef invy_sym = mkPredicateSymbol("Invy", {realSort()});
+    PTRef y = mkRealVar("y");
+    PTRef yp = mkRealVar("yp");
+    PTRef invx = instantiatePredicate(invx_sym, {x});
+    PTRef invy = instantiatePredicate(invy_sym, {y});
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{invx}},
+            ChcBody{{logic->mkEq(x, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invx_sym, {xp})}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{invx}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{invy}},
+            ChcBody{{logic->mkEq(y, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invy_sym, {yp})}},
+            ChcBody{{logic->mkEq(yp, logic->mkPlus(y, one))}, {UninterpretedPredicate{invy}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkLt(logic->mkPlus(x,y), zero)}, {UninterpretedPredicate{invx}, UninterpretedPredicate{invy}}}
+        }
+    };
+    Spacer engine(*logic, options);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE);
+}
+
 TEST_F(Spacer_LRA_Test, test_BasicNonLinearSystem_Unsafe)
 {
     options.addOption(Options::COMPUTE_WITNESS, "true");
@@ -222,3 +275,102 @@ TEST_F(Spacer_LRA_Test, test_UnsatProof_FactWithNoConstraints)
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
 }
 
+TEST_F(Spacer_LRA_Test, test_ParallelPushMatchesSequential_Safe)
+{
+    SymRef invx_sym = mkPredicateSymbol("Invx", {realSort()});
+    SymRef invy_sym = mkPredicateSymbol("Invy", {realSort()});
+    PTRef y = mkRealVar("y");
+    PTRef yp = mkRealVar("yp");
+    PTRef invx = instantiatePredicate(invx_sym, {x});
+    PTRef invy = instantiatePredicate(invy_sym, {y});
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{invx}},
+            ChcBody{{logic->mkEq(x, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invx_sym, {xp})}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{invx}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{invy}},
+            ChcBody{{logic->mkEq(y, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invy_sym, {yp})}},
+            ChcBody{{logic->mkEq(yp, logic->mkPlus(y, two))}, {UninterpretedPredicate{invy}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkLt(logic->mkPlus(x,y), zero)}, {UninterpretedPredicate{invx}, UninterpretedPredicate{invy}}}
+        }
+    };
+    solveSequentiallyAndInParallel(clauses, VerificationAnswer::SAFE);
+}
+
+TEST_F(Spacer_LRA_Test, test_ParallelPushMatchesSequential_Unsafe)
+{
+    SymRef invx_sym = mkPredicateSymbol("Invx", {realSort()});
+    SymRef invy_sym = mkPredicateSymbol("Invy", {realSort()});
+    PTRef y = mkRealVar("y");
+    PTRef yp = mkRealVar("yp");
+    PTRef invx = instantiatePredicate(invx_sym, {x});
+    PTRef invy = instantiatePredicate(invy_sym, {y});
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{invx}},
+            ChcBody{{logic->mkEq(x, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invx_sym, {xp})}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{invx}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{invy}},
+            ChcBody{{logic->mkEq(y, zero)}, {}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{instantiatePredicate(invy_sym, {yp})}},
+            ChcBody{{logic->mkEq(yp, logic->mkPlus(y, two))}, {UninterpretedPredicate{invy}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(logic->mkPlus(x,y), logic->mkRealConst(FastRational(5)))}, {UninterpretedPredicate{invx}, UninterpretedPredicate{invy}}}
+        }
+    };
+    solveSequentiallyAndInParallel(clauses, VerificationAnswer::UNSAFE);
+}
+
+class SpacerLemmas_Test : public LRAEngineTest {
+protected:
+    PTRef y = mkRealVar("y");
+};
+
+TEST_F(SpacerLemmas_Test, test_ConjunctiveLemmaReducedToCore)
+{
+    PTRef xNonPositive = logic->mkLeq(x, zero);
+    PTRef yNonPositive = logic->mkLeq(y, zero);
+    PTRef lemma = logic->mkAnd(xNonPositive, yNonPositive);
+    auto generalized = SpacerLemmas(*logic).generalize(lemma, lemma, logic->mkGt(x, one));
+    ASSERT_EQ(generalized.size(), 1);
+    EXPECT_EQ(generalized[0], xNonPositive);
+}
+
+TEST_F(SpacerLemmas_Test, test_UnneededDisjunctDropped)
+{
+    PTRef xNonPositive = logic->mkLeq(x, zero);
+    PTRef lemma = logic->mkOr(xNonPositive, logic->mkLeq(y, zero));
+    auto generalized = SpacerLemmas(*logic).generalize(lemma, logic->mkLt(x, zero), logic->mkGt(x, one));
+    ASSERT_EQ(generalized.size(), 1);
+    EXPECT_EQ(generalized[0], xNonPositive);
+}
+
+TEST_F(SpacerLemmas_Test, test_SubsumedComponentsFound)
+{
+    PTRef lemma = logic->mkLeq(x, zero);
+    PTRef weaker = logic->mkLeq(x, one);
+    vec<PTRef> components{weaker, logic->mkLeq(y, zero), lemma, logic->mkLeq(x, logic->mkMinus(zero, one))};
+    auto subsumed = SpacerLemmas(*logic).subsumedBy(lemma, components);
+    ASSERT_EQ(subsumed.size(), 1);
+    EXPECT_EQ(subsumed[0], weaker);
+}
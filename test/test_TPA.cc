@@ -6,6 +6,7 @@
 
 #include "TestTemplate.h"
 
+#include "TransitionSystem.h"
 #include "engine/TPA.h"
 
 class TPATest : public LIAEngineTest {
@@ -34,6 +35,35 @@ TEST_F(TPATest, test_TPA_simple_safe)
     solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
 }
 
+TEST_F(TPATest, test_TPA_SharedInvariant_safe)
+{
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    SymRef s1 = mkPredicateSymbol("s1", {intSort(), intSort()});
+    PTRef current = instantiatePredicate(s1, {x, y});
+    PTRef next = instantiatePredicate(s1, {xp, yp});
+    std::vector<ChClause> clauses{
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, zero), logic->mkEq(yp, zero))}, {}}},
+        {
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, logic->mkPlus(x, one)), logic->mkEq(yp, logic->mkPlus(y, one)))},
+                    {UninterpretedPredicate{current}}}
+        },
+        {
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkLt(x, y)}, {UninterpretedPredicate{current}}}
+        }};
+    LemmaBus bus;
+    LemmaBus::Subscription publisher(bus, *logic);
+    ASSERT_TRUE(publisher.publish(current, logic->mkEq(x, y)));
+    ASSERT_TRUE(publisher.publish(current, logic->mkGeq(x, zero)));
+    TPAEngine engine(*logic, options, TPACore::SPLIT);
+    engine.setLemmaBus(&bus);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
 TEST_F(TPATest, test_TPA_simple_unsafe)
 {
     options.addOption(Options::LOGIC, "QF_LIA");
@@ -129,6 +159,53 @@ TEST_F(TPATest, test_TPA_CEX_six) {
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
 }
 
+TEST_F(TPATest, test_TPA_RebuildEveryLevel_safe) {
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    options.addOption(Options::TPA_REBUILD, "1");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort(), intSort()});
+    PTRef current = instantiatePredicate(s1, {x, y});
+    PTRef next = instantiatePredicate(s1, {xp, yp});
+    std::vector<ChClause> clauses{{ // x' = 0 and y' = 0 => S1(x', y')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, zero), logic->mkEq(yp, zero))}, {}}
+        },
+        { // S1(x, y) and x' = x + 1 and y' = y + 2 => S1(x', y')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkAnd(logic->mkEq(xp, logic->mkPlus(x, one)), logic->mkEq(yp, logic->mkPlus(y, logic->mkIntConst(2))))},
+                    {UninterpretedPredicate{current}}}
+        },
+        { // S1(x, y) and y < x => false
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkLt(y, x)}, {UninterpretedPredicate{current}}}
+        }};
+    TPAEngine engine(*logic, options, TPACore::SPLIT);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_F(TPATest, test_TPA_SpeculativeThreads_unsafe) {
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    options.addOption(Options::TPA_THREADS, "3");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    PTRef current = instantiatePredicate(s1, {x});
+    PTRef next = instantiatePredicate(s1, {xp});
+    std::vector<ChClause> clauses{{ // x' = 0 => S1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, zero)}, {}}
+        },
+        { // S1(x) and x' = x + 1 => S1(x')
+            ChcHead{UninterpretedPredicate{next}},
+            ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))}, {UninterpretedPredicate{current}}}
+        },
+        { // S1(x) and x = 11 => false
+            ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+            ChcBody{{logic->mkEq(x, logic->mkIntConst(11))}, {UninterpretedPredicate{current}}}
+        }};
+    TPAEngine engine(*logic, options, TPACore::SPLIT);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
 TEST_F(TPATest, test_TPA_chain_of_two_unsafe) {
     Options options;
     options.addOption(Options::LOGIC, "QF_LIA");
@@ -261,6 +338,111 @@ TEST_F(TPATest, test_TPA_graph_of_three_unsafe) {
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
 }
 
+TEST_F(TPATest, test_TPA_graph_of_three_NetworkThreads_safe) {
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    options.addOption(Options::TPA_NETWORK_THREADS, "3");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    SymRef s2 = mkPredicateSymbol("s2", {intSort()});
+    SymRef s3 = mkPredicateSymbol("s3", {intSort()});
+    PTRef predS1Current = instantiatePredicate(s1, {x});
+    PTRef predS1Next = instantiatePredicate(s1, {xp});
+    PTRef predS2Current = instantiatePredicate(s2, {x});
+    PTRef predS2Next = instantiatePredicate(s2, {xp});
+    PTRef predS3Current = instantiatePredicate(s3, {x});
+    PTRef predS3Next = instantiatePredicate(s3, {xp});
+    std::vector<ChClause> clauses{{ // x = 0 => S1(x)
+                                          ChcHead{UninterpretedPredicate{predS1Current}},
+                                          ChcBody{{logic->mkEq(x, zero)}, {}}
+                                  },
+                                  { // S1(x) & x' = x + 1 => S1(x')
+                                          ChcHead{UninterpretedPredicate{predS1Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))},
+                                                  {UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S1(x) => S2(x)
+                                          ChcHead{UninterpretedPredicate{predS2Current}},
+                                          ChcBody{{}, {UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S1(x) => S3(x)
+                                          ChcHead{UninterpretedPredicate{predS3Current}},
+                                          ChcBody{{},{UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S2(x) & x' = x + 1 => S2(x')
+                                          ChcHead{UninterpretedPredicate{predS2Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))},
+                                                  {UninterpretedPredicate{predS2Current}}}
+                                  },
+                                  { // S3(x) & x' = x + 2 => S3(x')
+                                          ChcHead{UninterpretedPredicate{predS3Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkPlus(x, two))},
+                                                  {UninterpretedPredicate{predS3Current}}}
+                                  },
+                                  { // S2(x) & x < 0 => false
+                                          ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+                                          ChcBody{{logic->mkLt(x, zero)}, {UninterpretedPredicate{predS2Current}}}
+                                  },
+                                  { // S3(x) & x < 0 => false
+                                          ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+                                          ChcBody{{logic->mkLt(x, zero)}, {UninterpretedPredicate{predS3Current}}}
+                                  }};
+    TPAEngine engine(*logic, options, TPACore::SPLIT);
+    solveSystem(clauses, engine, VerificationAnswer::SAFE, true);
+}
+
+TEST_F(TPATest, test_TPA_diamond_NetworkThreads_unsafe) {
+    // S3 is safe from the states of S1, which are speculated, but not from the states of S2, which reach it later
+    options.addOption(Options::COMPUTE_WITNESS, "true");
+    options.addOption(Options::ENGINE, TPAEngine::SPLIT_TPA);
+    options.addOption(Options::TPA_NETWORK_THREADS, "3");
+    SymRef s1 = mkPredicateSymbol("s1", {intSort()});
+    SymRef s2 = mkPredicateSymbol("s2", {intSort()});
+    SymRef s3 = mkPredicateSymbol("s3", {intSort()});
+    PTRef predS1Current = instantiatePredicate(s1, {x});
+    PTRef predS1Next = instantiatePredicate(s1, {xp});
+    PTRef predS2Current = instantiatePredicate(s2, {x});
+    PTRef predS2Next = instantiatePredicate(s2, {xp});
+    PTRef predS3Current = instantiatePredicate(s3, {x});
+    PTRef predS3Next = instantiatePredicate(s3, {xp});
+    std::vector<ChClause> clauses{{ // x = 0 => S1(x)
+                                          ChcHead{UninterpretedPredicate{predS1Current}},
+                                          ChcBody{{logic->mkEq(x, zero)}, {}}
+                                  },
+                                  { // S1(x) & x' = x + 1 => S1(x')
+                                          ChcHead{UninterpretedPredicate{predS1Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkPlus(x, one))},
+                                                  {UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S1(x) => S2(x)
+                                          ChcHead{UninterpretedPredicate{predS2Current}},
+                                          ChcBody{{}, {UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S1(x) => S3(x)
+                                          ChcHead{UninterpretedPredicate{predS3Current}},
+                                          ChcBody{{},{UninterpretedPredicate{predS1Current}}}
+                                  },
+                                  { // S2(x) & x' = x - 1 => S2(x')
+                                          ChcHead{UninterpretedPredicate{predS2Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkMinus(x, one))},
+                                                  {UninterpretedPredicate{predS2Current}}}
+                                  },
+                                  { // S2(x) => S3(x)
+                                          ChcHead{UninterpretedPredicate{predS3Current}},
+                                          ChcBody{{},{UninterpretedPredicate{predS2Current}}}
+                                  },
+                                  { // S3(x) & x' = x + 2 => S3(x')
+                                          ChcHead{UninterpretedPredicate{predS3Next}},
+                                          ChcBody{{logic->mkEq(xp, logic->mkPlus(x, two))},
+                                                  {UninterpretedPredicate{predS3Current}}}
+                                  },
+                                  { // S3(x) & x < 0 => false
+                                          ChcHead{UninterpretedPredicate{logic->getTerm_false()}},
+                                          ChcBody{{logic->mkLt(x, zero)}, {UninterpretedPredicate{predS3Current}}}
+                                  }};
+    TPAEngine engine(*logic, options, TPACore::SPLIT);
+    solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
+}
+
 TEST_F(TPATest, test_TPA_chain_of_two_safe) {
     Options options;
     options.addOption(Options::LOGIC, "QF_LIA");
@@ -822,4 +1004,85 @@ TEST_F(TPATest, test_TPA_BeyondTransitionSystemDAG_Branching_Unsafe2)
         }};
     TPAEngine engine(*logic, options, TPACore::SPLIT);
     solveSystem(clauses, engine, VerificationAnswer::UNSAFE, true);
-}
\ No newline at end of file
+}
+
+TEST_F(TPATest, test_QueryCache_SubsumptionAndEviction) {
+    TPAQueryCache cache(*logic, 2);
+    PTRef transition = logic->mkEq(xp, logic->mkPlus(x, one));
+    PTRef from = logic->mkGeq(x, zero);
+    PTRef to = logic->mkLt(x, zero);
+    int solver = 0;
+    TPAQueryCache::Producer producer{&solver, 0};
+    TPAQueryResult unreachable;
+    unreachable.result = ReachabilityResult::UNREACHABLE;
+    cache.insert({transition, TPAType::EQUALS, 1, from, to}, unreachable, producer);
+    // Unreachable results answer queries with stronger states, but only unreachability queries on the same level
+    PTRef strongerTo = logic->mkAnd(to, logic->mkGt(y, zero));
+    EXPECT_TRUE(cache.knownUnreachable({transition, TPAType::EQUALS, 1, from, strongerTo}, producer));
+    EXPECT_FALSE(cache.knownUnreachable({transition, TPAType::EQUALS, 2, from, strongerTo}, producer));
+    EXPECT_FALSE(cache.knownUnreachable({transition, TPAType::EQUALS, 1, logic->getTerm_true(), to}, producer));
+    EXPECT_FALSE(cache.find({transition, TPAType::EQUALS, 1, from, to}).has_value());
+    TPAQueryResult reachable;
+    reachable.result = ReachabilityResult::REACHABLE;
+    reachable.refinedTarget = to;
+    reachable.steps = 2;
+    cache.insert({transition, TPAType::EQUALS, 0, to, to}, reachable, producer);
+    ASSERT_TRUE(cache.find({transition, TPAType::EQUALS, 0, to, to}).has_value());
+    EXPECT_EQ(cache.find({transition, TPAType::EQUALS, 0, to, to})->steps, 2);
+    // The least recently used entry is the unreachable one
+    cache.insert({transition, TPAType::LESS_THAN, 0, to, to}, reachable, producer);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_FALSE(cache.knownUnreachable({transition, TPAType::EQUALS, 1, from, to}, producer));
+    EXPECT_EQ(cache.hits(), 3);
+    EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST_F(TPATest, test_QueryCache_UnreachableOnlyForItsProducer) {
+    TPAQueryCache cache(*logic, 10);
+    PTRef increment = logic->mkEq(xp, logic->mkPlus(x, one));
+    PTRef from = logic->mkGeq(x, zero);
+    PTRef to = logic->mkLt(x, zero);
+    int first = 0;
+    int second = 0;
+    TPAQueryResult unreachable;
+    unreachable.result = ReachabilityResult::UNREACHABLE;
+    cache.insert({increment, TPAType::LESS_THAN, 1, from, to}, unreachable, {&first, 0});
+    PTRef strongerFrom = logic->mkAnd(from, logic->mkGt(y, zero));
+    EXPECT_TRUE(cache.knownUnreachable({increment, TPAType::LESS_THAN, 1, strongerFrom, to}, {&first, 0}));
+    // Another solver, or the same solver after its abstraction has been discarded, has not been strengthened
+    EXPECT_FALSE(cache.knownUnreachable({increment, TPAType::LESS_THAN, 1, strongerFrom, to}, {&second, 0}));
+    EXPECT_FALSE(cache.knownUnreachable({increment, TPAType::LESS_THAN, 1, from, to}, {&second, 0}));
+    EXPECT_FALSE(cache.knownUnreachable({increment, TPAType::LESS_THAN, 1, from, to}, {&first, 1}));
+    // Reachable results are shared by all solvers
+    TPAQueryResult reachable;
+    reachable.result = ReachabilityResult::REACHABLE;
+    reachable.refinedTarget = to;
+    reachable.steps = 1;
+    PTRef decrement = logic->mkEq(xp, logic->mkMinus(x, one));
+    cache.insert({decrement, TPAType::LESS_THAN, 1, from, to}, reachable, {&second, 0});
+    EXPECT_TRUE(cache.find({decrement, TPAType::LESS_THAN, 1, from, to}).has_value());
+    EXPECT_FALSE(cache.knownUnreachable({decrement, TPAType::LESS_THAN, 1, from, to}, {&second, 0}));
+}
+
+TEST_F(TPATest, test_QueryCache_SharedBySolversWithDifferentTransitions) {
+    auto cache = TPAQueryCache::fromOptions(*logic, options);
+    auto makeSystem = [&](bool increasing) {
+        auto type = std::make_unique<SystemType>(std::vector<SRef>{intSort()}, *logic);
+        PTRef v = type->getStateVars()[0];
+        PTRef vp = type->getNextStateVars()[0];
+        PTRef step = logic->mkEq(vp, increasing ? logic->mkPlus(v, one) : logic->mkMinus(v, one));
+        return TransitionSystem(*logic, std::move(type), logic->mkEq(v, zero), step, logic->mkLt(v, zero));
+    };
+    auto increasing = makeSystem(true);
+    auto decreasing = makeSystem(false);
+    TPASplit first(*logic, options);
+    TPASplit second(*logic, options);
+    first.setQueryCache(cache);
+    second.setQueryCache(cache);
+    EXPECT_EQ(first.solveTransitionSystem(increasing), VerificationAnswer::SAFE);
+    EXPECT_EQ(second.solveTransitionSystem(decreasing), VerificationAnswer::UNSAFE);
+    EXPECT_EQ(second.solveTransitionSystem(increasing), VerificationAnswer::SAFE);
+    EXPECT_EQ(first.solveTransitionSystem(decreasing), VerificationAnswer::UNSAFE);
+    EXPECT_EQ(first.solveTransitionSystem(increasing), VerificationAnswer::SAFE);
+    EXPECT_GT(cache->size(), 0);
+}
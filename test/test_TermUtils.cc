@@ -111,4 +111,71 @@ TEST_F(TermUtils_Test, test_TopLevelDisjuncts_NestedTwoLevels) {
     EXPECT_TRUE(contains(disjunctions, na));
     EXPECT_TRUE(contains(disjunctions, nb));
     EXPECT_TRUE(contains(disjunctions, nc));
-}
\ No newline at end of file
+}
+
+TEST(VersionManager_Test, test_VersionsRoundTrip) {
+    ArithLogic logic {opensmt::Logic_t::QF_LRA};
+    VersionManager manager {logic};
+    PTRef x = logic.mkRealVar("x");
+    PTRef y = logic.mkRealVar("y");
+    PTRef fla = logic.mkLeq(x, y);
+    PTRef source = manager.baseFormulaToSource(fla, 1);
+    PTRef target = manager.baseFormulaToTarget(fla);
+    EXPECT_EQ(source, logic.mkLeq(logic.mkRealVar("x__s##1"), logic.mkRealVar("y__s##1")));
+    EXPECT_EQ(target, logic.mkLeq(logic.mkRealVar("x__t"), logic.mkRealVar("y__t")));
+    EXPECT_EQ(manager.baseFormulaToSource(fla, 1), source);
+    EXPECT_NE(manager.baseFormulaToSource(fla, 0), source);
+    EXPECT_EQ(manager.sourceFormulaToBase(source), fla);
+    EXPECT_EQ(manager.targetFormulaToBase(target), fla);
+    EXPECT_EQ(manager.sourceFormulaToTarget(source), target);
+    // Variables not created by this manager are still recognized by their names
+    EXPECT_EQ(VersionManager(logic).sourceFormulaToBase(source), fla);
+}
+
+TEST(VersionManager_Test, test_CopyVersionsLikeOriginal) {
+    ArithLogic logic {opensmt::Logic_t::QF_LRA};
+    VersionManager manager {logic};
+    PTRef fla = logic.mkLeq(logic.mkRealVar("x"), logic.mkRealVar("y"));
+    PTRef target = manager.baseFormulaToTarget(fla);
+    VersionManager copy {manager};
+    EXPECT_EQ(copy.baseFormulaToTarget(fla), target);
+    EXPECT_EQ(copy.targetFormulaToBase(target), fla);
+    EXPECT_EQ(manager.baseFormulaToTarget(fla), target);
+}
+
+TEST(TimeMachine_Test, test_IndexedVersionsMatchNames) {
+    ArithLogic logic {opensmt::Logic_t::QF_LRA};
+    TimeMachine timeMachine {logic};
+    PTRef x0 = timeMachine.getVarVersionZero("x", logic.getSort_real());
+    PTRef x12 = timeMachine.sendVarThroughTime(x0, 12);
+    EXPECT_EQ(x12, logic.mkRealVar("x##12"));
+    EXPECT_EQ(timeMachine.getVersionNumber(x12), 12);
+    EXPECT_EQ(timeMachine.sendVarThroughTime(x12, -10), logic.mkRealVar("x##2"));
+    EXPECT_EQ(timeMachine.sendVarThroughTime(x12, -12), x0);
+    EXPECT_EQ(timeMachine.getUnversioned(x12), logic.mkRealVar("x"));
+    EXPECT_EQ(timeMachine.getUnversionedName(x12), "x");
+    // A variable first seen in a later version is indexed by its name
+    PTRef y3 = logic.mkRealVar("y##3");
+    EXPECT_TRUE(timeMachine.isVersioned(y3));
+    EXPECT_EQ(timeMachine.getVersionNumber(y3), 3);
+    EXPECT_EQ(timeMachine.sendVarThroughTime(y3, -3), timeMachine.getVarVersionZero("y", logic.getSort_real()));
+    // Another instance builds its own tables and agrees with the first one
+    TimeMachine other {logic};
+    EXPECT_EQ(other.getVersionNumber(x12), 12);
+    EXPECT_EQ(other.sendVarThroughTime(x12, 1), timeMachine.sendVarThroughTime(x0, 13));
+    PTRef fla = logic.mkLeq(x0, y3);
+    EXPECT_EQ(timeMachine.sendFlaThroughTime(fla, 2), logic.mkLeq(logic.mkRealVar("x##2"), logic.mkRealVar("y##5")));
+}
+
+TEST(UnrollingCache_Test, test_VersionsAreSharedAcrossRequests) {
+    ArithLogic logic {opensmt::Logic_t::QF_LRA};
+    TimeMachine timeMachine {logic};
+    PTRef x = timeMachine.getVarVersionZero("x", logic.getSort_real());
+    PTRef fla = logic.mkLeq(x, logic.getTerm_RealZero());
+    UnrollingCache unrollings {logic};
+    EXPECT_EQ(unrollings.getVersion(fla, 0), fla);
+    PTRef third = unrollings.getVersion(fla, 3);
+    EXPECT_EQ(third, timeMachine.sendFlaThroughTime(fla, 3));
+    EXPECT_EQ(unrollings.getVersion(fla, 3), third);
+    EXPECT_EQ(unrollings.getVersion(fla, 1), timeMachine.sendFlaThroughTime(fla, 1));
+}